@@ -0,0 +1,86 @@
+/*
+ * Tiny timing harness shared by the host benchmarks. Each case is calibrated
+ * to run for at least BENCH_MIN_NS, repeated BENCH_REPEATS times, and the
+ * fastest repeat (the least disturbed by the rest of the machine) is reported
+ * as one JSON line:
+ *
+ *   {"name": "...", "ns_per_op": 12.3, "ops": 1000000}
+ *
+ * bench/run.py collects these lines into the results file.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef BENCH_MIN_NS
+#define BENCH_MIN_NS    100000000ULL
+#endif
+#ifndef BENCH_REPEATS
+#define BENCH_REPEATS   7
+#endif
+
+/* Run the measured operation `iters` times. */
+typedef void (*bench_fn_t)(void *arg, uint64_t iters);
+
+/* Sink for results that must not be optimized away. */
+static volatile uint64_t bench_sink;
+
+static inline uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * Time fn and print its result to out. ops_per_iter scales the reported cost
+ * when one call covers several logical operations (e.g. a batch of windows).
+ */
+static inline void bench_run(FILE *out, const char *name, bench_fn_t fn, void *arg,
+                             uint64_t ops_per_iter)
+{
+    uint64_t iters = 1;
+    uint64_t elapsed;
+    double best = 0.0;
+
+    for (;;) {
+        uint64_t t0 = bench_now_ns();
+        fn(arg, iters);
+        elapsed = bench_now_ns() - t0;
+        if (elapsed >= BENCH_MIN_NS / 10 || iters >= (1ULL << 40)) {
+            break;
+        }
+        iters *= 2;
+    }
+    if (elapsed < BENCH_MIN_NS) {
+        iters = (uint64_t)((double)iters * BENCH_MIN_NS / (elapsed ? elapsed : 1)) + 1;
+    }
+
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        uint64_t t0 = bench_now_ns();
+        fn(arg, iters);
+        double ns = (double)(bench_now_ns() - t0) / ((double)iters * ops_per_iter);
+        if (r == 0 || ns < best) {
+            best = ns;
+        }
+    }
+
+    fprintf(out, "{\"name\": \"%s\", \"ns_per_op\": %.3f, \"ops\": %llu}\n",
+            name, best,
+            (unsigned long long)(iters * ops_per_iter));
+    fflush(out);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BENCH_H */
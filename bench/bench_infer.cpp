@@ -0,0 +1,135 @@
+/*
+ * Window inference on the host: the ml/infer forward pass on CNN1D- and
+ * ResNet1D-shaped models with random weights (no exported model needed).
+ * Reported per window, single-threaded so results are comparable across
+ * machines with different core counts.
+ */
+
+#include <random>
+#include <vector>
+
+#include "../ml/infer/model.hpp"
+#include "bench.h"
+
+namespace {
+
+struct infer_case_t {
+    model_t model;
+    thread_pool_t *pool;
+    int batch;
+    std::vector<float> x;
+    std::vector<float> logits;
+};
+
+std::mt19937 g_rng(0);
+
+op_t conv(int in, int out, int k, bool relu)
+{
+    std::normal_distribution<float> dist(0.0f, 0.1f);
+    op_t op;
+    op.type = OP_CONV;
+    op.in = in;
+    op.out = out;
+    op.k = k;
+    op.pad = k / 2;
+    op.relu = relu;
+    op.w.resize((size_t)out * in * k);
+    op.b.resize(out);
+    for (float &v : op.w) {
+        v = dist(g_rng);
+    }
+    for (float &v : op.b) {
+        v = dist(g_rng);
+    }
+    return op;
+}
+
+op_t linear(int in, int out, bool relu)
+{
+    op_t op = conv(in, out, 1, relu);
+    op.type = OP_LINEAR;
+    op.k = 0;
+    op.pad = 0;
+    return op;
+}
+
+op_t simple(op_type_t type, int k = 0)
+{
+    op_t op;
+    op.type = type;
+    op.k = k;
+    return op;
+}
+
+void add_res_block(model_t &m, int channels)
+{
+    m.ops.push_back(simple(OP_RES_BEGIN));
+    m.ops.push_back(conv(channels, channels, 3, true));
+    m.ops.push_back(conv(channels, channels, 3, false));
+    m.ops.push_back(simple(OP_RES_END));
+}
+
+/* Same layer shapes as models/cnn.py and models/resnet.py. */
+model_t make_model(bool resnet, int seq_len, int num_classes)
+{
+    model_t m;
+    m.seq_len = seq_len;
+    m.stride = seq_len / 2;
+    m.num_classes = num_classes;
+    m.ops.push_back(conv(1, 32, 5, true));
+    m.ops.push_back(simple(OP_MAXPOOL, 2));
+    if (resnet) {
+        add_res_block(m, 32);
+    }
+    m.ops.push_back(conv(32, 64, 5, true));
+    m.ops.push_back(simple(OP_MAXPOOL, 2));
+    if (resnet) {
+        add_res_block(m, 64);
+    }
+    m.ops.push_back(conv(64, 128, 3, true));
+    if (resnet) {
+        add_res_block(m, 128);
+    }
+    m.ops.push_back(simple(OP_GAP));
+    m.ops.push_back(linear(128, 128, true));
+    m.ops.push_back(linear(128, num_classes, false));
+    return m;
+}
+
+void run_forward(void *arg, uint64_t iters)
+{
+    infer_case_t *c = (infer_case_t *)arg;
+    for (uint64_t i = 0; i < iters; i++) {
+        model_forward(c->model, *c->pool, c->x.data(), c->batch, c->logits.data());
+    }
+    bench_sink += (uint64_t)c->logits[0];
+}
+
+void bench_case(thread_pool_t &pool, const char *name, bool resnet, int seq_len, int batch)
+{
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    infer_case_t c;
+
+    c.model = make_model(resnet, seq_len, 4);
+    c.pool = &pool;
+    c.batch = batch;
+    c.x.resize((size_t)batch * seq_len);
+    c.logits.resize((size_t)batch * c.model.num_classes);
+    for (float &v : c.x) {
+        v = dist(g_rng);
+    }
+    bench_run(stdout, name, run_forward, &c, (uint64_t)batch);
+}
+
+}  // namespace
+
+int main()
+{
+    thread_pool_t pool(1);
+
+    bench_case(pool, "infer_cnn_seq100_b1", false, 100, 1);
+    bench_case(pool, "infer_cnn_seq100_b64", false, 100, 64);
+    bench_case(pool, "infer_cnn_seq1000_b64", false, 1000, 64);
+    bench_case(pool, "infer_resnet_seq100_b64", true, 100, 64);
+    return 0;
+}
@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+"""Dataset preparation benchmark: time create_dataset() and the native
+create_dataset_stream() (ml/prep) on ml/data/raw.
+
+Prints one JSON line per case in the same format as the native benchmarks
+(ns_per_op is the fastest of REPEATS runs, per raw CSV row, and ns_spread
+the gap to the slowest one, as run.py reports it), plus the peak RSS of the
+case. Every case runs in a fresh process, so the peak is its own and not the
+largest of the cases before it.
+"""
+import json
+import os
+import resource
+import subprocess
+import sys
+import time
+
+ML_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "ml")
+REPEATS = 3
+
+# name -> (function in prepare_data, task, seq_len, overlap)
+CASES = {
+    "prep_node_seq100_ov50": ("create_dataset", "node", 100, 0.5),
+    "prep_env_seq1000_ov40": ("create_dataset", "env", 1000, 0.4),
+    "prep_stream_node_seq100_ov50": ("create_dataset_stream", "node", 100, 0.5),
+    "prep_stream_env_seq1000_ov40": ("create_dataset_stream", "env", 1000, 0.4),
+}
+
+
+def count_rows(files):
+    rows = 0
+    for path in files:
+        with open(path, "rb") as f:
+            rows += sum(1 for _ in f) - 1
+    return rows
+
+
+def bench(name):
+    os.chdir(ML_DIR)
+    sys.path.insert(0, os.path.join(ML_DIR, "src"))
+    import prepare_data
+
+    func, task, seq_len, overlap = CASES[name]
+    fn = getattr(prepare_data, func)
+    rows = count_rows(prepare_data.FILES)
+    samples = []
+    for _ in range(REPEATS):
+        t0 = time.perf_counter_ns()
+        fn(task, seq_len, overlap)
+        samples.append((time.perf_counter_ns() - t0) / rows)
+    rss_kb = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    print(json.dumps({"name": name, "ns_per_op": round(min(samples), 3),
+                      "ns_spread": round(max(samples) / min(samples) - 1, 3),
+                      "ops": rows * REPEATS, "max_rss_kb": rss_kb}), flush=True)
+
+
+def main():
+    if len(sys.argv) == 3 and sys.argv[1] == "--child":
+        bench(sys.argv[2])
+        return
+    for name in CASES:
+        subprocess.run([sys.executable, os.path.abspath(__file__), "--child", name], check=True)
+
+
+if __name__ == "__main__":
+    main()
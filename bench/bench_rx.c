@@ -0,0 +1,128 @@
+/*
+ * RX hot paths on the host: the firmware source is compiled as-is against
+ * the stubs in stubs/, so static functions such as gap_event() and
+ * name_matches() can be called directly. The firmware's CSV output goes to
+ * /dev/null through a fully buffered stdout; results go to the real stdout.
+ * Built once per payload variant (ENABLE_SENSOR), like the firmware.
+ */
+
+#define main rx_firmware_main
+#include "../iot/rx/main.c"
+#undef main
+
+#include <unistd.h>
+
+#include "bench.h"
+
+typedef struct {
+    struct ble_gap_event event;
+    conn_slot_t *slot;
+} notify_case_t;
+
+static void setup_slots(void)
+{
+    for (int i = 0; i < MAX_CONN; i++) {
+        conn_slot_t *slot = &g_conns[i];
+        memset(slot, 0, sizeof(*slot));
+        slot->state = CONN_CONNECTED;
+        slot->conn_handle = (uint16_t)(i + 1);
+        slot->addr.val[0] = (uint8_t)i;
+        snprintf(slot->name, sizeof(slot->name), "RIOT-BLE-%d", i);
+    }
+}
+
+static void setup_notify(notify_case_t *c, const void *payload, uint16_t len,
+                         conn_slot_t *slot, uint16_t conn_handle)
+{
+    static struct os_mbuf om;
+
+    memcpy(om.om_buf, payload, len);
+    om.om_data = om.om_buf;
+    om.om_len = len;
+    memset(c, 0, sizeof(*c));
+    c->event.type = BLE_GAP_EVENT_NOTIFY_RX;
+    c->event.notify_rx.om = &om;
+    c->event.notify_rx.conn_handle = conn_handle;
+    c->slot = slot;
+}
+
+static void run_notify(void *arg, uint64_t iters)
+{
+    notify_case_t *c = arg;
+    for (uint64_t i = 0; i < iters; i++) {
+        gap_event(&c->event, c->slot);
+    }
+}
+
+#if !ENABLE_SENSOR
+/* Cases that do not depend on the payload run in the minimal build only */
+typedef struct {
+    const uint8_t *name;
+    uint8_t len;
+} name_case_t;
+
+static void run_slot_lookup(void *arg, uint64_t iters)
+{
+    uint16_t handle = *(uint16_t *)arg;
+    for (uint64_t i = 0; i < iters; i++) {
+        bench_sink += (uintptr_t)find_slot_by_handle(handle);
+    }
+}
+
+static void run_name_matches(void *arg, uint64_t iters)
+{
+    name_case_t *c = arg;
+    for (uint64_t i = 0; i < iters; i++) {
+        bench_sink += (uint64_t)name_matches(c->name, c->len);
+    }
+}
+#endif
+
+int main(void)
+{
+    FILE *out = fdopen(dup(STDOUT_FILENO), "w");
+    static char stdout_buf[1 << 16];
+
+    if (!out || !freopen("/dev/null", "w", stdout)) {
+        return 1;
+    }
+    setvbuf(stdout, stdout_buf, _IOFBF, sizeof(stdout_buf));
+    setup_slots();
+
+    sample_t sample = { .seq = 1234 };
+    notify_case_t c;
+
+#if ENABLE_SENSOR
+    sample.temp_val = 2404;
+    sample.temp_scale = -2;
+    sample.hum_val = 4506;
+    sample.hum_scale = -2;
+    sample.press_val = 10089;
+    sample.press_scale = 1;
+
+    setup_notify(&c, &sample, sizeof(sample), &g_conns[0], g_conns[0].conn_handle);
+    bench_run(out, "rx_notify_full", run_notify, &c, 1);
+#else
+    setup_notify(&c, &sample, sizeof(sample), &g_conns[0], g_conns[0].conn_handle);
+    bench_run(out, "rx_notify_minimal", run_notify, &c, 1);
+
+    /* No callback arg: gap_event() has to look the slot up by handle. */
+    setup_notify(&c, &sample, sizeof(sample), NULL, g_conns[MAX_CONN - 1].conn_handle);
+    bench_run(out, "rx_notify_minimal_lookup", run_notify, &c, 1);
+
+    uint16_t last_handle = g_conns[MAX_CONN - 1].conn_handle;
+    bench_run(out, "rx_slot_lookup_last", run_slot_lookup, &last_handle, 1);
+
+    name_case_t names[] = {
+        { (const uint8_t *)"RIOT-BLE-12/34", 14 },
+        { (const uint8_t *)"RIOT-BLE-9", 10 },
+        { (const uint8_t *)"Some Headphones", 15 },
+    };
+    bench_run(out, "rx_name_matches_group", run_name_matches, &names[0], 1);
+    bench_run(out, "rx_name_matches_plain", run_name_matches, &names[1], 1);
+    bench_run(out, "rx_name_matches_reject", run_name_matches, &names[2], 1);
+#endif
+
+    fclose(out);
+    return 0;
+}
@@ -0,0 +1,39 @@
+/*
+ * TX sample packing on the host: one send_sample() call per operation, i.e.
+ * sensor reads (ENABLE_SENSOR=1), payload packing, mbuf allocation and copy,
+ * and notify framing (ATT/L2CAP/ACL headers, see nimble_stub.h). Built once
+ * per payload variant.
+ */
+
+#define main tx_firmware_main
+#include "../iot/tx/main.c"
+#undef main
+
+#include "bench.h"
+
+#if ENABLE_SENSOR
+#define BENCH_TX_NAME "tx_send_sensor"
+#else
+#define BENCH_TX_NAME "tx_send_minimal"
+#endif
+
+static void run_send(void *arg, uint64_t iters)
+{
+    uint16_t *seq = arg;
+    for (uint64_t i = 0; i < iters; i++) {
+        send_sample(seq);
+    }
+    bench_sink += stub_acl_tx_len;
+}
+
+int main(void)
+{
+    uint16_t seq = 0;
+
+    g_conn_state = 1;
+    g_notify_state = 1;
+    find_sensors();
+
+    bench_run(stdout, BENCH_TX_NAME, run_send, &seq, 1);
+    return 0;
+}
@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""Compare a benchmark results file against a stored baseline.
+
+    python bench/compare.py bench/baseline.json bench/results.json [--threshold 0.25]
+
+A case regresses when its ns_per_op grows by more than its limit (relative)
+and by more than --min-ns (absolute, to ignore timer noise on
+nanosecond-scale cases). The limit of a case is --threshold, or
+--spread-factor times the larger ns_spread (slowest/fastest run - 1) of the
+two files if that is wider, so that a case which is noisy on this machine
+does not fail on unchanged code. Cases with a peak RSS regress when it grows
+by more than --rss-threshold. A case missing from the current results fails
+too. Exits with status 1 if any case failed.
+"""
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        return json.load(f)["results"]
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.25,
+                        help="relative ns_per_op change treated as significant")
+    parser.add_argument("--spread-factor", type=float, default=1.5,
+                        help="widen a case's limit to this times its measured ns_spread")
+    parser.add_argument("--min-ns", type=float, default=5.0,
+                        help="absolute ns_per_op change below which a case is always ok")
+    parser.add_argument("--rss-threshold", type=float, default=0.10,
+                        help="relative max_rss_kb change treated as significant")
+    args = parser.parse_args()
+
+    base = load(args.baseline)
+    cur = load(args.current)
+    failures = 0
+
+    print(f"{'case':32} {'baseline ns':>14} {'current ns':>14} {'change':>9} {'limit':>7}  status")
+    for name in sorted(set(base) | set(cur)):
+        if name not in cur:
+            print(f"{name:32} {base[name]['ns_per_op']:14.1f} {'-':>14} {'':>9} {'':>7}  MISSING")
+            failures += 1
+            continue
+        if name not in base:
+            print(f"{name:32} {'-':>14} {cur[name]['ns_per_op']:14.1f} {'':>9} {'':>7}  NEW")
+            continue
+        b = base[name]["ns_per_op"]
+        c = cur[name]["ns_per_op"]
+        change = (c - b) / b if b > 0 else 0.0
+        spread = max(base[name].get("ns_spread", 0.0), cur[name].get("ns_spread", 0.0))
+        limit = max(args.threshold, args.spread_factor * spread)
+        if abs(c - b) <= args.min_ns:
+            status = "ok"
+        elif change > limit:
+            status = "REGRESSION"
+            failures += 1
+        elif change < -limit:
+            status = "improved"
+        else:
+            status = "ok"
+        print(f"{name:32} {b:14.1f} {c:14.1f} {change:+8.1%} {limit:6.0%}  {status}")
+
+        if "max_rss_kb" in base[name] and "max_rss_kb" in cur[name]:
+            b = base[name]["max_rss_kb"]
+            c = cur[name]["max_rss_kb"]
+            change = (c - b) / b if b > 0 else 0.0
+            if change > args.rss_threshold:
+                status = "REGRESSION"
+                failures += 1
+            elif change < -args.rss_threshold:
+                status = "improved"
+            else:
+                status = "ok"
+            print(f"{'  max_rss_kb':32} {b:14d} {c:14d} {change:+8.1%} "
+                  f"{args.rss_threshold:6.0%}  {status}")
+
+    if failures:
+        print(f"{failures} case(s) regressed or missing")
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""Run every benchmark and write one machine-readable results file.
+
+    python bench/run.py --out bench/results.json [--skip-prep]
+
+The native benchmarks are built with `make -C bench` first and run --runs
+times each, interleaved so that a slow spell of the machine hits every
+binary alike. Each case keeps its fastest result as ns_per_op, since timings
+of the short cases shift between processes (code/data placement), and the
+gap to its slowest result as ns_spread, which compare.py sizes the
+threshold of the case by.
+The dataset preparation benchmark runs with the current interpreter, so use
+the project environment (`uv run python bench/run.py ...`).
+"""
+import argparse
+import datetime
+import json
+import os
+import platform
+import subprocess
+import sys
+
+BENCH_DIR = os.path.dirname(os.path.abspath(__file__))
+NATIVE = ["bench_rx_minimal", "bench_rx_sensor", "bench_tx_minimal", "bench_tx_sensor", "bench_infer"]
+
+
+def parse_lines(output):
+    results = []
+    for line in output.splitlines():
+        line = line.strip()
+        if line.startswith("{"):
+            results.append(json.loads(line))
+    return results
+
+
+def run(cmd):
+    print("#", " ".join(cmd), file=sys.stderr, flush=True)
+    proc = subprocess.run(cmd, check=True, stdout=subprocess.PIPE, text=True)
+    return parse_lines(proc.stdout)
+
+
+def fastest(runs):
+    best = {}
+    slowest = {}
+    for results in runs:
+        for r in results:
+            name = r["name"]
+            if name not in best or r["ns_per_op"] < best[name]["ns_per_op"]:
+                best[name] = r
+            slowest[name] = max(slowest.get(name, 0.0), r["ns_per_op"])
+    for name, r in best.items():
+        r["ns_spread"] = round(slowest[name] / r["ns_per_op"] - 1, 3) if r["ns_per_op"] > 0 else 0.0
+    return list(best.values())
+
+
+def git_rev():
+    try:
+        return subprocess.run(["git", "rev-parse", "--short", "HEAD"], cwd=BENCH_DIR,
+                              check=True, stdout=subprocess.PIPE, text=True).stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--out", type=str, default=os.path.join(BENCH_DIR, "results.json"))
+    parser.add_argument("--skip-prep", action="store_true",
+                        help="skip the (slow, pandas-based) dataset preparation cases")
+    parser.add_argument("--runs", type=int, default=5,
+                        help="processes per native benchmark, the fastest result is kept")
+    args = parser.parse_args()
+
+    subprocess.run(["make", "-C", BENCH_DIR, "all"], check=True, stdout=subprocess.DEVNULL)
+
+    runs = {name: [] for name in NATIVE}
+    for _ in range(args.runs):
+        for name in NATIVE:
+            runs[name].append(run([os.path.join(BENCH_DIR, "bin", name)]))
+    results = []
+    for name in NATIVE:
+        results += fastest(runs[name])
+    if not args.skip_prep:
+        results += run([sys.executable, os.path.join(BENCH_DIR, "bench_prep.py")])
+
+    report = {
+        "meta": {
+            "date": datetime.datetime.now().isoformat(timespec="seconds"),
+            "git_rev": git_rev(),
+            "host": platform.node(),
+            "machine": platform.machine(),
+            "python": platform.python_version(),
+        },
+        "results": {r.pop("name"): r for r in results},
+    }
+    with open(args.out, "w") as f:
+        json.dump(report, f, indent=4)
+        f.write("\n")
+    print("Saved to:", args.out)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,19 @@
+/*
+ * Size probe for `make size`: includes one firmware source and keeps its
+ * callbacks referenced, so the host object reflects the code that would be
+ * linked into the firmware instead of being optimized away with the stubs.
+ *
+ * These are host -Os objects built against the inline stubs in stubs/, not a
+ * firmware footprint: NimBLE, RIOT and the sensor drivers are not in them, the
+ * TX bss holds the stub mbuf pool, and the instruction set is the host's. Use
+ * them to compare the payload variants with each other; `make -C iot/<app>`
+ * gives the real flash/RAM figures.
+ */
+
+#if SIZE_RX
+#include "../iot/rx/main.c"
+void *const size_roots[] = { (void *)gap_event, (void *)scan_event };
+#else
+#include "../iot/tx/main.c"
+void *const size_roots[] = { (void *)gap_event, (void *)send_sample };
+#endif
@@ -0,0 +1,7 @@
+/* Host stub, see nimble_stub.h */
+#ifndef STUB_HOST_BLE_GAP_H
+#define STUB_HOST_BLE_GAP_H
+
+#include "nimble_stub.h"
+
+#endif /* STUB_HOST_BLE_GAP_H */
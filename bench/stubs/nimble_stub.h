@@ -0,0 +1,528 @@
+/*
+ * Minimal host stand-ins for the RIOT / NimBLE APIs used by iot/rx and iot/tx,
+ * so the firmware sources can be compiled unmodified into host benchmarks.
+ * Only what the firmware touches is declared; the stack calls do no work
+ * beyond what the hot paths need (mbuf allocation, copying payloads, framing
+ * notifications, reporting an RSSI).
+ */
+
+#ifndef NIMBLE_STUB_H
+#define NIMBLE_STUB_H
+
+#include <stdint.h>
+#include <string.h>
+
+/* ztimer */
+
+typedef struct { int unused; } ztimer_clock_t;
+static ztimer_clock_t stub_ztimer_msec;
+#define ZTIMER_MSEC (&stub_ztimer_msec)
+
+static inline void ztimer_sleep(ztimer_clock_t *clock, uint32_t duration)
+{
+    (void)clock;
+    (void)duration;
+}
+
+/* UUIDs and addresses */
+
+#define BLE_UUID_TYPE_16 16
+
+typedef struct {
+    uint8_t type;
+} ble_uuid_t;
+
+typedef struct {
+    ble_uuid_t u;
+    uint16_t value;
+} ble_uuid16_t;
+
+typedef union {
+    ble_uuid_t u;
+    ble_uuid16_t u16;
+} ble_uuid_any_t;
+
+#define BLE_UUID16_INIT(uuid16) { .u = { .type = BLE_UUID_TYPE_16 }, .value = (uuid16) }
+#define BLE_UUID16_DECLARE(uuid16) \
+    ((ble_uuid_t *)(&(ble_uuid16_t) BLE_UUID16_INIT(uuid16)))
+
+static inline int ble_uuid_cmp(const ble_uuid_t *a, const ble_uuid_t *b)
+{
+    return (int)((const ble_uuid16_t *)a)->value - (int)((const ble_uuid16_t *)b)->value;
+}
+
+static inline uint16_t ble_uuid_u16(const ble_uuid_t *u)
+{
+    return ((const ble_uuid16_t *)u)->value;
+}
+
+typedef struct {
+    uint8_t type;
+    uint8_t val[6];
+} ble_addr_t;
+
+/*
+ * mbufs: one flat buffer is enough for single-notification hot paths. TX
+ * takes them from a small pool, like NimBLE's msys pool, with leading space
+ * for the ATT, L2CAP and HCI ACL headers the host prepends.
+ */
+
+#define STUB_MBUF_LEN       64
+#define STUB_MBUF_LEADING   16
+#define STUB_MBUF_POOL      4
+
+struct os_mbuf {
+    uint8_t *om_data;
+    uint16_t om_len;
+    struct os_mbuf *om_next;    /* free list */
+    uint8_t om_buf[STUB_MBUF_LEADING + STUB_MBUF_LEN];
+};
+
+static struct os_mbuf stub_mbuf_pool[STUB_MBUF_POOL];
+static struct os_mbuf *stub_mbuf_free;
+static uint8_t stub_mbuf_pool_ready;
+
+static inline int os_mbuf_copydata(const struct os_mbuf *om, int off, int len, void *dst)
+{
+    if (off + len > om->om_len) {
+        return -1;
+    }
+    memcpy(dst, om->om_data + off, (size_t)len);
+    return 0;
+}
+
+static inline int os_mbuf_free_chain(struct os_mbuf *om)
+{
+    if (om) {
+        om->om_next = stub_mbuf_free;
+        stub_mbuf_free = om;
+    }
+    return 0;
+}
+
+static inline struct os_mbuf *stub_mbuf_get(void)
+{
+    if (!stub_mbuf_pool_ready) {
+        for (int i = 0; i < STUB_MBUF_POOL; i++) {
+            os_mbuf_free_chain(&stub_mbuf_pool[i]);
+        }
+        stub_mbuf_pool_ready = 1;
+    }
+    struct os_mbuf *om = stub_mbuf_free;
+    if (om) {
+        stub_mbuf_free = om->om_next;
+        om->om_data = om->om_buf + STUB_MBUF_LEADING;
+        om->om_len = 0;
+    }
+    return om;
+}
+
+/* NULL if there is no leading space left (NimBLE would chain a new mbuf) */
+static inline uint8_t *stub_mbuf_prepend(struct os_mbuf *om, uint16_t len)
+{
+    if (om->om_data - om->om_buf < len) {
+        return NULL;
+    }
+    om->om_data -= len;
+    om->om_len += len;
+    return om->om_data;
+}
+
+static inline struct os_mbuf *ble_hs_mbuf_from_flat(const void *buf, uint16_t len)
+{
+    if (len > STUB_MBUF_LEN) {
+        return NULL;
+    }
+    struct os_mbuf *om = stub_mbuf_get();
+    if (om) {
+        memcpy(om->om_data, buf, len);
+        om->om_len = len;
+    }
+    return om;
+}
+
+static inline void stub_put_le16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+/* GAP */
+
+#define BLE_GAP_EVENT_CONNECT           0
+#define BLE_GAP_EVENT_DISCONNECT        1
+#define BLE_GAP_EVENT_DISC              7
+#define BLE_GAP_EVENT_DISC_COMPLETE     8
+#define BLE_GAP_EVENT_ADV_COMPLETE      9
+#define BLE_GAP_EVENT_NOTIFY_RX         12
+#define BLE_GAP_EVENT_NOTIFY_TX         13
+#define BLE_GAP_EVENT_SUBSCRIBE         14
+
+#define BLE_GAP_CONN_MODE_UND           2
+#define BLE_GAP_DISC_MODE_GEN           2
+#define BLE_HS_ADV_F_DISC_GEN           0x02
+#define BLE_ERR_REM_USER_CONN_TERM      0x13
+
+struct ble_gap_conn_desc {
+    uint16_t conn_handle;
+};
+
+struct ble_gap_disc_desc {
+    uint8_t event_type;
+    uint8_t length_data;
+    ble_addr_t addr;
+    int8_t rssi;
+    const uint8_t *data;
+};
+
+struct ble_gap_event {
+    uint8_t type;
+    union {
+        struct {
+            int status;
+            uint16_t conn_handle;
+        } connect;
+        struct {
+            int reason;
+            struct ble_gap_conn_desc conn;
+        } disconnect;
+        struct ble_gap_disc_desc disc;
+        struct {
+            struct os_mbuf *om;
+            uint16_t attr_handle;
+            uint16_t conn_handle;
+            uint8_t indication;
+        } notify_rx;
+        struct {
+            uint16_t conn_handle;
+            uint16_t attr_handle;
+            uint8_t reason;
+            uint8_t prev_notify;
+            uint8_t cur_notify;
+        } subscribe;
+    };
+};
+
+typedef int ble_gap_event_fn(struct ble_gap_event *event, void *arg);
+
+struct ble_gap_disc_params {
+    uint16_t itvl;
+    uint16_t window;
+    uint8_t filter_policy;
+    uint8_t limited : 1;
+    uint8_t passive : 1;
+    uint8_t filter_duplicates : 1;
+};
+
+struct ble_gap_adv_params {
+    uint8_t conn_mode;
+    uint8_t disc_mode;
+    uint16_t itvl_min;
+    uint16_t itvl_max;
+};
+
+struct ble_gap_conn_params;
+
+struct ble_hs_adv_fields {
+    uint8_t flags;
+    const ble_uuid16_t *uuids16;
+    uint8_t num_uuids16;
+    unsigned uuids16_is_complete : 1;
+    const uint8_t *name;
+    uint8_t name_len;
+    unsigned name_is_complete : 1;
+};
+
+/* RSSI reported by ble_gap_conn_rssi(), settable by the benchmark. */
+static int8_t stub_conn_rssi = -70;
+
+static inline int ble_gap_conn_rssi(uint16_t conn_handle, int8_t *out_rssi)
+{
+    (void)conn_handle;
+    *out_rssi = stub_conn_rssi;
+    return 0;
+}
+
+static inline int ble_gap_terminate(uint16_t conn_handle, uint8_t hci_reason)
+{
+    (void)conn_handle;
+    (void)hci_reason;
+    return 0;
+}
+
+static inline int ble_gap_disc(uint8_t own_addr_type, int32_t duration_ms,
+                               const struct ble_gap_disc_params *disc_params,
+                               ble_gap_event_fn *cb, void *cb_arg)
+{
+    (void)own_addr_type;
+    (void)duration_ms;
+    (void)disc_params;
+    (void)cb;
+    (void)cb_arg;
+    return 0;
+}
+
+static inline int ble_gap_disc_cancel(void)
+{
+    return 0;
+}
+
+static inline int ble_gap_connect(uint8_t own_addr_type, const ble_addr_t *peer_addr,
+                                  int32_t duration_ms,
+                                  const struct ble_gap_conn_params *params,
+                                  ble_gap_event_fn *cb, void *cb_arg)
+{
+    (void)own_addr_type;
+    (void)peer_addr;
+    (void)duration_ms;
+    (void)params;
+    (void)cb;
+    (void)cb_arg;
+    return 0;
+}
+
+static inline int ble_gap_adv_set_fields(const struct ble_hs_adv_fields *fields)
+{
+    (void)fields;
+    return 0;
+}
+
+static inline int ble_gap_adv_start(uint8_t own_addr_type, const ble_addr_t *direct_addr,
+                                    int32_t duration_ms,
+                                    const struct ble_gap_adv_params *adv_params,
+                                    ble_gap_event_fn *cb, void *cb_arg)
+{
+    (void)own_addr_type;
+    (void)direct_addr;
+    (void)duration_ms;
+    (void)adv_params;
+    (void)cb;
+    (void)cb_arg;
+    return 0;
+}
+
+static inline int ble_hs_adv_parse_fields(struct ble_hs_adv_fields *adv_fields,
+                                          const uint8_t *src, uint8_t src_len)
+{
+    (void)adv_fields;
+    (void)src;
+    (void)src_len;
+    return 0;
+}
+
+static inline int ble_hs_util_ensure_addr(int prefer_random)
+{
+    (void)prefer_random;
+    return 0;
+}
+
+static inline int ble_hs_id_infer_auto(int privacy, uint8_t *out_addr_type)
+{
+    (void)privacy;
+    *out_addr_type = 0;
+    return 0;
+}
+
+/* GATT */
+
+#define BLE_GATT_SVC_TYPE_PRIMARY       1
+#define BLE_GATT_CHR_F_NOTIFY           0x0010
+#define BLE_ATT_ERR_UNLIKELY            0x0e
+
+struct ble_gatt_error {
+    uint16_t status;
+    uint16_t att_handle;
+};
+
+struct ble_gatt_chr {
+    uint16_t def_handle;
+    uint16_t val_handle;
+    uint8_t properties;
+    ble_uuid_any_t uuid;
+};
+
+struct ble_gatt_svc {
+    uint16_t start_handle;
+    uint16_t end_handle;
+    ble_uuid_any_t uuid;
+};
+
+struct ble_gatt_access_ctxt;
+
+typedef int ble_gatt_access_fn(uint16_t conn_handle, uint16_t attr_handle,
+                               struct ble_gatt_access_ctxt *ctxt, void *arg);
+typedef int ble_gatt_chr_fn(uint16_t conn_handle, const struct ble_gatt_error *error,
+                            const struct ble_gatt_chr *chr, void *arg);
+typedef int ble_gatt_disc_svc_fn(uint16_t conn_handle, const struct ble_gatt_error *error,
+                                 const struct ble_gatt_svc *service, void *arg);
+typedef int ble_gatt_attr_fn(uint16_t conn_handle, const struct ble_gatt_error *error,
+                             void *attr, void *arg);
+
+struct ble_gatt_chr_def {
+    const ble_uuid_t *uuid;
+    ble_gatt_access_fn *access_cb;
+    void *arg;
+    uint16_t flags;
+    uint16_t *val_handle;
+};
+
+struct ble_gatt_svc_def {
+    uint8_t type;
+    const ble_uuid_t *uuid;
+    const struct ble_gatt_chr_def *characteristics;
+};
+
+struct ble_gatt_access_ctxt {
+    uint8_t op;
+    struct os_mbuf *om;
+    const struct ble_gatt_chr_def *chr;
+};
+
+static inline int ble_gattc_write_flat(uint16_t conn_handle, uint16_t attr_handle,
+                                       const void *data, uint16_t data_len,
+                                       ble_gatt_attr_fn *cb, void *cb_arg)
+{
+    (void)conn_handle;
+    (void)attr_handle;
+    (void)data;
+    (void)data_len;
+    (void)cb;
+    (void)cb_arg;
+    return 0;
+}
+
+static inline int ble_gattc_disc_all_chrs(uint16_t conn_handle, uint16_t start_handle,
+                                          uint16_t end_handle, ble_gatt_chr_fn *cb,
+                                          void *cb_arg)
+{
+    (void)conn_handle;
+    (void)start_handle;
+    (void)end_handle;
+    (void)cb;
+    (void)cb_arg;
+    return 0;
+}
+
+static inline int ble_gattc_disc_svc_by_uuid(uint16_t conn_handle, const ble_uuid_t *uuid,
+                                             ble_gatt_disc_svc_fn *cb, void *cb_arg)
+{
+    (void)conn_handle;
+    (void)uuid;
+    (void)cb;
+    (void)cb_arg;
+    return 0;
+}
+
+#define BLE_ATT_OP_NOTIFY_REQ           0x1b
+#define BLE_L2CAP_CID_ATT               0x0004
+#define BLE_HCI_PB_FIRST_FLUSH          0x2000
+#define STUB_ATT_NOTIFY_HDR             3
+#define STUB_ACL_HDRS                   (4 + 4)     /* HCI ACL + L2CAP */
+
+/* Last HCI ACL packet handed to the controller */
+static uint8_t stub_acl_tx[STUB_MBUF_LEADING + STUB_MBUF_LEN];
+static uint16_t stub_acl_tx_len;
+
+/*
+ * Frame om as an ATT Handle Value Notification in an L2CAP basic frame in an
+ * HCI ACL packet, hand it to the "controller" and consume om, as NimBLE does.
+ */
+static inline int ble_gatts_notify_custom(uint16_t conn_handle, uint16_t att_handle,
+                                          struct os_mbuf *om)
+{
+    uint8_t *att = stub_mbuf_prepend(om, STUB_ATT_NOTIFY_HDR);
+    uint8_t *hdr = att ? stub_mbuf_prepend(om, STUB_ACL_HDRS) : NULL;
+
+    if (!hdr) {
+        os_mbuf_free_chain(om);
+        return BLE_ATT_ERR_UNLIKELY;
+    }
+    att[0] = BLE_ATT_OP_NOTIFY_REQ;
+    stub_put_le16(att + 1, att_handle);
+    stub_put_le16(hdr, (uint16_t)(conn_handle | BLE_HCI_PB_FIRST_FLUSH));
+    stub_put_le16(hdr + 2, (uint16_t)(om->om_len - 4));
+    stub_put_le16(hdr + 4, (uint16_t)(om->om_len - STUB_ACL_HDRS));
+    stub_put_le16(hdr + 6, BLE_L2CAP_CID_ATT);
+
+    memcpy(stub_acl_tx, om->om_data, om->om_len);
+    stub_acl_tx_len = om->om_len;
+    os_mbuf_free_chain(om);
+    return 0;
+}
+
+/* Value of the last notification sent, or NULL */
+static inline const uint8_t *stub_last_notify(uint16_t *len)
+{
+    const uint16_t hdrs = STUB_ACL_HDRS + STUB_ATT_NOTIFY_HDR;
+
+    if (stub_acl_tx_len < hdrs || stub_acl_tx[STUB_ACL_HDRS] != BLE_ATT_OP_NOTIFY_REQ) {
+        return NULL;
+    }
+    *len = (uint16_t)(stub_acl_tx_len - hdrs);
+    return stub_acl_tx + hdrs;
+}
+
+static inline int ble_gatts_count_cfg(const struct ble_gatt_svc_def *defs)
+{
+    (void)defs;
+    return 0;
+}
+
+static inline int ble_gatts_add_svcs(const struct ble_gatt_svc_def *svcs)
+{
+    (void)svcs;
+    return 0;
+}
+
+static inline int ble_gatts_start(void)
+{
+    return 0;
+}
+
+static inline int ble_svc_gap_device_name_set(const char *name)
+{
+    (void)name;
+    return 0;
+}
+
+/* SAUL */
+
+#define SAUL_SENSE_TEMP     0x82
+#define SAUL_SENSE_HUM      0x83
+#define SAUL_SENSE_PRESS    0x8a
+
+typedef struct {
+    int16_t val[3];
+    uint8_t unit;
+    int8_t scale;
+} phydat_t;
+
+typedef struct saul_reg {
+    uint8_t type;
+    phydat_t value;
+} saul_reg_t;
+
+static saul_reg_t stub_saul_devs[] = {
+    { SAUL_SENSE_TEMP, { { 2404, 0, 0 }, 0, -2 } },
+    { SAUL_SENSE_HUM, { { 4506, 0, 0 }, 0, -2 } },
+    { SAUL_SENSE_PRESS, { { 10089, 0, 0 }, 0, 1 } },
+};
+
+static inline saul_reg_t *saul_reg_find_type_and_name(uint8_t type, const char *name)
+{
+    (void)name;
+    for (size_t i = 0; i < sizeof(stub_saul_devs) / sizeof(stub_saul_devs[0]); i++) {
+        if (stub_saul_devs[i].type == type) {
+            return &stub_saul_devs[i];
+        }
+    }
+    return NULL;
+}
+
+static inline int saul_reg_read(saul_reg_t *dev, phydat_t *res)
+{
+    *res = dev->value;
+    return 1;
+}
+
+#endif /* NIMBLE_STUB_H */
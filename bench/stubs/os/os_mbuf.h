@@ -0,0 +1,7 @@
+/* Host stub, see nimble_stub.h */
+#ifndef STUB_OS_OS_MBUF_H
+#define STUB_OS_OS_MBUF_H
+
+#include "nimble_stub.h"
+
+#endif /* STUB_OS_OS_MBUF_H */
@@ -0,0 +1,7 @@
+/* Host stub, see nimble_stub.h */
+#ifndef STUB_SAUL_REG_H
+#define STUB_SAUL_REG_H
+
+#include "nimble_stub.h"
+
+#endif /* STUB_SAUL_REG_H */
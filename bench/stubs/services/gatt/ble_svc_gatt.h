@@ -0,0 +1,7 @@
+/* Host stub, see nimble_stub.h */
+#ifndef STUB_SERVICES_GATT_BLE_SVC_GATT_H
+#define STUB_SERVICES_GATT_BLE_SVC_GATT_H
+
+#include "nimble_stub.h"
+
+#endif /* STUB_SERVICES_GATT_BLE_SVC_GATT_H */
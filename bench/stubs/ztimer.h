@@ -0,0 +1,7 @@
+/* Host stub, see nimble_stub.h */
+#ifndef STUB_ZTIMER_H
+#define STUB_ZTIMER_H
+
+#include "nimble_stub.h"
+
+#endif /* STUB_ZTIMER_H */
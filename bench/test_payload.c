@@ -0,0 +1,89 @@
+/*
+ * Payload round trip on the host, built once per variant like the firmware:
+ * TX send_sample() packs seq 1234 and the stub sensor values into a
+ * notification (test_payload_tx.c), RX gap_event() prints it, and the CSV
+ * line must match the one log_rx.sh expects byte for byte. Also checks that
+ * the firmware header matches the rx.csv schema.
+ */
+
+#define main rx_firmware_main
+#include "../iot/rx/main.c"
+#undef main
+
+#include <unistd.h>
+
+#include "rx_csv.h"
+
+#define LINE_BUF        128
+
+#if ENABLE_SENSOR
+#define EXPECTED_LINE   "RIOT-BLE-0,1234,2404,-2,4506,-2,10089,1,-70\n"
+#else
+#define EXPECTED_LINE   "RIOT-BLE-0,1234,,,,,,,-70\n"
+#endif
+
+uint16_t tx_send(uint16_t seq, uint8_t *buf, uint16_t cap);
+
+static int g_failed;
+
+static void check_str(const char *what, const char *got, const char *expected)
+{
+    if (strcmp(got, expected) != 0) {
+        printf("FAIL %s:\n  got      %s  expected %s", what, got, expected);
+        g_failed = 1;
+    }
+}
+
+/* Run gap_event() with stdout redirected, return its first CSV line in out. */
+static void rx_notify(const uint8_t *payload, uint16_t len, char *out, size_t cap)
+{
+    struct ble_gap_event event;
+    struct os_mbuf om;
+    FILE *capture = tmpfile();
+    int saved = dup(STDOUT_FILENO);
+
+    memcpy(om.om_buf, payload, len);
+    om.om_data = om.om_buf;
+    om.om_len = len;
+    memset(&event, 0, sizeof(event));
+    event.type = BLE_GAP_EVENT_NOTIFY_RX;
+    event.notify_rx.om = &om;
+    event.notify_rx.conn_handle = g_conns[0].conn_handle;
+
+    fflush(stdout);
+    dup2(fileno(capture), STDOUT_FILENO);
+    gap_event(&event, &g_conns[0]);
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+
+    out[0] = '\0';
+    rewind(capture);
+    while (fgets(out, (int)cap, capture) && out[0] == '#') {
+        out[0] = '\0';      /* RX_LOG lines */
+    }
+    fclose(capture);
+}
+
+int main(void)
+{
+    uint8_t payload[STUB_MBUF_LEN];
+    char line[LINE_BUF];
+
+    memset(&g_conns[0], 0, sizeof(g_conns[0]));
+    g_conns[0].state = CONN_CONNECTED;
+    g_conns[0].conn_handle = 1;
+    snprintf(g_conns[0].name, sizeof(g_conns[0].name), "RIOT-BLE-0");
+
+    uint16_t len = tx_send(1234, payload, sizeof(payload));
+    if (len != sizeof(sample_t)) {
+        printf("FAIL notify length %u, expected %zu\n", (unsigned)len, sizeof(sample_t));
+        return 1;
+    }
+    rx_notify(payload, len, line, sizeof(line));
+    check_str("rx line", line, EXPECTED_LINE);
+    check_str("header", "ts," PAYLOAD_CSV_HEADER, RX_CSV_HEADER "\n");
+
+    printf("%s payload ENABLE_SENSOR=%d\n", g_failed ? "FAIL" : "ok", ENABLE_SENSOR);
+    return g_failed;
+}
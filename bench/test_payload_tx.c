@@ -0,0 +1,31 @@
+/*
+ * TX half of test_payload: the TX firmware lives in its own translation unit
+ * because its statics (gap_event(), g_conn_handle, ...) clash with the RX
+ * ones. tx_send() runs the real send_sample() and hands back the value of the
+ * notification it sent.
+ */
+
+#define main tx_firmware_main
+#include "../iot/tx/main.c"
+#undef main
+
+uint16_t tx_send(uint16_t seq, uint8_t *buf, uint16_t cap);
+
+uint16_t tx_send(uint16_t seq, uint8_t *buf, uint16_t cap)
+{
+    g_conn_state = 1;
+    g_notify_state = 1;
+    find_sensors();
+
+    uint16_t len;
+    const uint8_t *value;
+
+    stub_acl_tx_len = 0;
+    send_sample(&seq);
+    value = stub_last_notify(&len);
+    if (!value || len > cap) {
+        return 0;
+    }
+    memcpy(buf, value, len);
+    return len;
+}
@@ -0,0 +1,72 @@
+/*
+ * Notification payload shared by TX and RX.
+ *
+ * The sensor fields are listed once in PAYLOAD_SENSORS; every field is sent
+ * as a raw phydat value + scale pair. The payload variant is fixed at build
+ * time by ENABLE_SENSOR (pass the same value to both firmwares):
+ *
+ *   ENABLE_SENSOR=0   seq only                                   (2 bytes)
+ *   ENABLE_SENSOR=1   seq + temp/hum/press value and scale pairs (11 bytes)
+ *
+ * sample_t, the TX sensor reads, the RX CSV format and the CSV header are all
+ * expanded from this list, so each firmware only carries the code for its own
+ * variant and RX never has to guess the variant from the notification length.
+ * The RX CSV line keeps the same columns in both variants; the sensor columns
+ * are left empty when ENABLE_SENSOR=0.
+ */
+
+#ifndef PAYLOAD_H
+#define PAYLOAD_H
+
+#include <stdint.h>
+
+#ifndef ENABLE_SENSOR
+#define ENABLE_SENSOR       0
+#endif
+
+/*
+ * X(arg, name, saul_type, saul_name), in wire and CSV column order. arg is
+ * passed through unchanged so an expansion can refer to a variable.
+ */
+#define PAYLOAD_SENSORS(X, arg)                     \
+    X(arg, temp,  SAUL_SENSE_TEMP,  "bmp280")       \
+    X(arg, hum,   SAUL_SENSE_HUM,   "sht3x1")       \
+    X(arg, press, SAUL_SENSE_PRESS, "bmp280")
+
+#if ENABLE_SENSOR
+#define PAYLOAD_FIELDS(X, arg)  PAYLOAD_SENSORS(X, arg)
+#define PAYLOAD_ABSENT(X, arg)
+#else
+#define PAYLOAD_FIELDS(X, arg)
+#define PAYLOAD_ABSENT(X, arg)  PAYLOAD_SENSORS(X, arg)
+#endif
+
+#define PAYLOAD_STRUCT_FIELD(a, name, type, dev)    int16_t name##_val; int8_t name##_scale;
+#define PAYLOAD_WIRE_SIZE(a, name, type, dev)       + 3
+#define PAYLOAD_CSV_HEADER_FIELD(a, name, type, dev) "," #name "_val," #name "_scale"
+#define PAYLOAD_CSV_FMT_FIELD(a, name, type, dev)   ",%d,%d"
+#define PAYLOAD_CSV_EMPTY_FIELD(a, name, type, dev) ",,"
+#define PAYLOAD_CSV_ARG(s, name, type, dev)         , (s).name##_val, (s).name##_scale
+
+typedef struct __attribute__((packed)) {
+    uint16_t seq;
+    PAYLOAD_FIELDS(PAYLOAD_STRUCT_FIELD, _)
+} sample_t;
+
+_Static_assert(sizeof(sample_t) == 2 PAYLOAD_FIELDS(PAYLOAD_WIRE_SIZE, _),
+               "sample_t must match the wire format");
+
+/* RX CSV header: PAYLOAD_CSV_FMT columns, without the ts added by log_rx.sh */
+#define PAYLOAD_CSV_HEADER \
+    "device,seq" PAYLOAD_SENSORS(PAYLOAD_CSV_HEADER_FIELD, _) ",rssi\n"
+
+/* RX CSV line: device, seq, sensor columns, rssi */
+#define PAYLOAD_CSV_FMT                             \
+    "%s,%u" PAYLOAD_FIELDS(PAYLOAD_CSV_FMT_FIELD, _) \
+    PAYLOAD_ABSENT(PAYLOAD_CSV_EMPTY_FIELD, _) ",%d\n"
+
+/* printf arguments matching the seq and sensor part of PAYLOAD_CSV_FMT */
+#define PAYLOAD_CSV_ARGS(s) \
+    (s).seq PAYLOAD_FIELDS(PAYLOAD_CSV_ARG, s)
+
+#endif /* PAYLOAD_H */
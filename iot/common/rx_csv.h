@@ -0,0 +1,210 @@
+/*
+ * Parsing and formatting of the rx.csv rows written by log_rx.sh:
+ *
+ *   ts,device,seq,temp_val,temp_scale,hum_val,hum_scale,press_val,press_scale,rssi
+ *
+ * Header-only so that host tools (merger, inference, benchmarks) can share it
+ * without a library. Timestamps are the naive pyterm wall clock
+ * ("YYYY-MM-DD HH:MM:SS.mmm") and are converted to milliseconds without any
+ * timezone handling.
+ */
+
+#ifndef RX_CSV_H
+#define RX_CSV_H
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RX_CSV_HEADER \
+    "ts,device,seq,temp_val,temp_scale,hum_val,hum_scale,press_val,press_scale,rssi"
+#define RX_CSV_DEVICE_MAX   31
+#define RX_CSV_FIELDS_MAX   63
+#define RX_CSV_TS_LEN       23
+#define RX_CSV_TS_BUF       (RX_CSV_TS_LEN + 1)
+#define RX_CSV_RSSI_UNKNOWN 127
+
+typedef struct {
+    int64_t ts_ms;
+    uint16_t seq;
+    int8_t rssi;
+    char device[RX_CSV_DEVICE_MAX + 1];
+    /* raw "temp_val,...,press_scale" text, passed through untouched */
+    char fields[RX_CSV_FIELDS_MAX + 1];
+} rx_row_t;
+
+static inline int64_t rx_csv_days_from_civil(int64_t y, unsigned m, unsigned d)
+{
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = (unsigned)(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int64_t)doe - 719468;
+}
+
+static inline void rx_csv_civil_from_days(int64_t z, int *y, unsigned *m,
+                                          unsigned *d)
+{
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = (unsigned)(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    *d = doy - (153 * mp + 2) / 5 + 1;
+    *m = mp < 10 ? mp + 3 : mp - 9;
+    *y = (int)(yoe + era * 400 + (*m <= 2));
+}
+
+static inline int rx_csv_digits(const char *s, int n, unsigned *out)
+{
+    unsigned v = 0;
+    for (int i = 0; i < n; i++) {
+        if (s[i] < '0' || s[i] > '9') {
+            return -1;
+        }
+        v = v * 10 + (unsigned)(s[i] - '0');
+    }
+    *out = v;
+    return 0;
+}
+
+/* Parse "YYYY-MM-DD HH:MM:SS.mmm" (exactly RX_CSV_TS_LEN chars). */
+static inline int rx_csv_parse_ts(const char *s, size_t len, int64_t *out_ms)
+{
+    unsigned y, mo, d, h, mi, sec, ms;
+
+    if (len != RX_CSV_TS_LEN || s[4] != '-' || s[7] != '-' || s[10] != ' ' ||
+        s[13] != ':' || s[16] != ':' || s[19] != '.') {
+        return -1;
+    }
+    if (rx_csv_digits(s, 4, &y) || rx_csv_digits(s + 5, 2, &mo) ||
+        rx_csv_digits(s + 8, 2, &d) || rx_csv_digits(s + 11, 2, &h) ||
+        rx_csv_digits(s + 14, 2, &mi) || rx_csv_digits(s + 17, 2, &sec) ||
+        rx_csv_digits(s + 20, 3, &ms)) {
+        return -1;
+    }
+    if (mo < 1 || mo > 12 || d < 1 || d > 31) {
+        return -1;
+    }
+    int64_t days = rx_csv_days_from_civil((int64_t)y, mo, d);
+    *out_ms = ((days * 24 + h) * 60 + mi) * 60000 + (int64_t)sec * 1000 + ms;
+    return 0;
+}
+
+static inline void rx_csv_put_digits(char *out, unsigned v, int n)
+{
+    for (int i = n - 1; i >= 0; i--) {
+        out[i] = (char)('0' + v % 10);
+        v /= 10;
+    }
+}
+
+/* Format milliseconds back into the rx.csv timestamp; out needs RX_CSV_TS_BUF bytes. */
+static inline void rx_csv_format_ts(int64_t ts_ms, char *out)
+{
+    int64_t days = ts_ms >= 0 ? ts_ms / 86400000 : -((-ts_ms + 86399999) / 86400000);
+    unsigned rem = (unsigned)(ts_ms - days * 86400000);
+    int y;
+    unsigned m, d;
+
+    rx_csv_civil_from_days(days, &y, &m, &d);
+    memcpy(out, "0000-00-00 00:00:00.000", RX_CSV_TS_LEN + 1);
+    rx_csv_put_digits(out, (unsigned)y, 4);
+    rx_csv_put_digits(out + 5, m, 2);
+    rx_csv_put_digits(out + 8, d, 2);
+    rx_csv_put_digits(out + 11, rem / 3600000, 2);
+    rx_csv_put_digits(out + 14, rem / 60000 % 60, 2);
+    rx_csv_put_digits(out + 17, rem / 1000 % 60, 2);
+    rx_csv_put_digits(out + 20, rem % 1000, 3);
+}
+
+static inline int rx_csv_parse_int(const char *s, size_t len, long *out)
+{
+    size_t i = 0;
+    int neg = 0;
+    long v = 0;
+
+    if (len > 0 && s[0] == '-') {
+        neg = 1;
+        i = 1;
+    }
+    if (i == len || len - i > 9) {
+        return -1;
+    }
+    for (; i < len; i++) {
+        if (s[i] < '0' || s[i] > '9') {
+            return -1;
+        }
+        v = v * 10 + (s[i] - '0');
+    }
+    *out = neg ? -v : v;
+    return 0;
+}
+
+/*
+ * Parse one rx.csv line (without the trailing newline; a '\r' is tolerated).
+ * Returns 0 on success, -1 for headers, comments and malformed lines.
+ */
+static inline int rx_csv_parse_line(const char *line, size_t len, rx_row_t *row)
+{
+    const char *col[10];
+    size_t col_len[10];
+    size_t n = 0;
+    size_t start = 0;
+    long v;
+
+    if (len > 0 && line[len - 1] == '\r') {
+        len--;
+    }
+    for (size_t i = 0; i <= len; i++) {
+        if (i == len || line[i] == ',') {
+            if (n == 10) {
+                return -1;
+            }
+            col[n] = line + start;
+            col_len[n] = i - start;
+            n++;
+            start = i + 1;
+        }
+    }
+    if (n != 10) {
+        return -1;
+    }
+    if (rx_csv_parse_ts(col[0], col_len[0], &row->ts_ms) != 0) {
+        return -1;
+    }
+    if (col_len[1] == 0 || col_len[1] > RX_CSV_DEVICE_MAX) {
+        return -1;
+    }
+    memcpy(row->device, col[1], col_len[1]);
+    row->device[col_len[1]] = '\0';
+
+    if (rx_csv_parse_int(col[2], col_len[2], &v) != 0 || v < 0 || v > 0xffff) {
+        return -1;
+    }
+    row->seq = (uint16_t)v;
+
+    if (rx_csv_parse_int(col[9], col_len[9], &v) != 0 || v < -128 || v > 127) {
+        return -1;
+    }
+    row->rssi = (int8_t)v;
+
+    size_t fields_len = (size_t)(col[8] + col_len[8] - col[3]);
+    if (fields_len > RX_CSV_FIELDS_MAX) {
+        return -1;
+    }
+    memcpy(row->fields, col[3], fields_len);
+    row->fields[fields_len] = '\0';
+    return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RX_CSV_H */
@@ -0,0 +1,785 @@
+/*
+ * Multi-gateway merger (host): read the rx.csv streams of several RX gateways,
+ * align records by (device, seq, ts), estimate each gateway's clock offset and
+ * emit one deduplicated, time-ordered rx.csv stream on stdout.
+ *
+ *   iot_merge [options] [name=]path [[name=]path ...]
+ *
+ * The first input is the reference clock. Inputs may be regular files,
+ * FIFOs or ptys fed by log_rx.sh. At --max-pending records, files are read
+ * no further ahead and only live inputs force records out.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "rx_csv.h"
+
+#define READ_CHUNK          (64 * 1024)
+#define LINE_MAX_LEN        256
+#define POLL_TIMEOUT_MS     100
+#define MATCH_COLD_MS       10000
+#define MATCH_MIN_MS        10
+#define MATCH_JITTER_K      4.0
+#define RETAIN_MS           MATCH_COLD_MS
+#define OFFSET_ALPHA        (1.0 / 64)
+#define OFFSET_CLAMP_MS     1000.0
+#define JITTER_INIT_MS      10.0
+
+namespace {
+
+struct options_t {
+    bool follow = false;
+    bool per_gateway = false;
+    bool stats = false;
+    int64_t lateness_ms = 500;
+    int64_t idle_ms = 2000;
+    size_t max_pending = 4096;
+};
+
+struct source_t {
+    std::string name;
+    std::string path;
+    int fd = -1;
+    bool regular = false;
+    bool open = false;
+    std::string buf;
+    int64_t last_ts = INT64_MIN;    /* latest raw ts seen */
+    int64_t last_wall_ms = 0;       /* monotonic time of latest row, or of open */
+    double offset_ms = 0.0;         /* raw ts minus reference clock */
+    double jitter_ms = 0.0;         /* mean abs deviation of offset samples */
+    bool offset_ready = false;
+    uint64_t offset_samples = 0;
+    uint64_t rows = 0;
+    uint64_t bad = 0;
+    uint64_t dups = 0;
+    uint64_t late = 0;              /* copies of an already emitted sample */
+    uint64_t dropped = 0;           /* new samples behind the emitted ones */
+};
+
+/* One sample of one device, pending or recently emitted */
+struct record_t {
+    int64_t ts;                     /* min corrected ts over gateways */
+    int device;
+    uint16_t seq;
+    bool emitted = false;
+    std::string fields;
+    std::vector<int64_t> raw_ts;    /* per gateway, INT64_MIN if missing */
+    std::vector<int8_t> rssi;       /* per gateway, RX_CSV_RSSI_UNKNOWN if missing */
+};
+
+/* (corrected ts, record id) */
+typedef std::pair<int64_t, uint64_t> order_key_t;
+
+struct stats_t {
+    uint64_t emitted = 0;
+    uint64_t merged = 0;
+    uint64_t forced = 0;
+    size_t pending_peak = 0;
+};
+
+options_t g_opts;
+std::vector<source_t> g_sources;
+std::vector<std::string> g_devices;
+std::unordered_map<std::string, int> g_device_ids;
+std::unordered_map<uint64_t, record_t> g_records;
+std::unordered_multimap<uint32_t, uint64_t> g_by_seq;  /* (device, seq) -> id */
+std::set<order_key_t> g_order;                          /* pending records */
+std::deque<uint64_t> g_retired;                         /* emitted, oldest first */
+uint64_t g_next_id;                                     /* 0 is no record */
+int64_t g_frontier = INT64_MIN;                         /* latest emitted ts */
+stats_t g_stats;
+volatile sig_atomic_t g_stop;
+
+void on_signal(int sig)
+{
+    (void)sig;
+    g_stop = 1;
+}
+
+int64_t mono_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+int device_id(const char *name)
+{
+    auto it = g_device_ids.find(name);
+    if (it != g_device_ids.end()) {
+        return it->second;
+    }
+    int id = (int)g_devices.size();
+    g_devices.emplace_back(name);
+    g_device_ids.emplace(name, id);
+    return id;
+}
+
+/* Returns true if this was the first sample, which sets the offset outright. */
+bool offset_update(source_t &src, double sample)
+{
+    bool first = !src.offset_ready;
+
+    if (first) {
+        src.offset_ms = sample;
+        src.jitter_ms = JITTER_INIT_MS;
+        src.offset_ready = true;
+    } else {
+        double err = sample - src.offset_ms;
+        err = std::max(-OFFSET_CLAMP_MS, std::min(OFFSET_CLAMP_MS, err));
+        src.offset_ms += OFFSET_ALPHA * err;
+        src.jitter_ms += OFFSET_ALPHA * (std::fabs(err) - src.jitter_ms);
+    }
+    src.offset_samples++;
+    return first;
+}
+
+int64_t corrected_ts(const source_t &src, int64_t raw)
+{
+    return raw - (int64_t)(src.offset_ms >= 0 ? src.offset_ms + 0.5 : src.offset_ms - 0.5);
+}
+
+/*
+ * Pending records keep the corrected ts they got on arrival. Once a gateway's
+ * offset becomes known, the ones it delivered before were timed with no
+ * offset at all: re-time and re-sort them all.
+ */
+void retime_pending(void)
+{
+    std::set<order_key_t> order;
+
+    for (const order_key_t &key : g_order) {
+        record_t &r = g_records.at(key.second);
+        r.ts = INT64_MAX;
+        for (size_t h = 0; h < g_sources.size(); h++) {
+            if (r.raw_ts[h] != INT64_MIN) {
+                r.ts = std::min(r.ts, corrected_ts(g_sources[h], r.raw_ts[h]));
+            }
+        }
+        order.emplace(r.ts, key.second);
+    }
+    g_order.swap(order);
+}
+
+/*
+ * A gateway joined a record another gateway already holds: the difference of
+ * their raw timestamps is one sample of their relative clock offset. Offsets
+ * propagate from the reference (gateway 0) through any overlapping gateway.
+ */
+void offsets_from_pair(record_t &p, size_t g)
+{
+    bool ready = false;
+
+    for (size_t h = 0; h < g_sources.size(); h++) {
+        if (h == g || p.raw_ts[h] == INT64_MIN) {
+            continue;
+        }
+        source_t &sg = g_sources[g];
+        source_t &sh = g_sources[h];
+        double diff = (double)(p.raw_ts[g] - p.raw_ts[h]);
+        if (g != 0 && sh.offset_ready) {
+            ready |= offset_update(sg, diff + sh.offset_ms);
+        } else if (h != 0 && sg.offset_ready) {
+            ready |= offset_update(sh, -diff + sg.offset_ms);
+        }
+    }
+    if (ready) {
+        retime_pending();
+    }
+}
+
+uint32_t seq_key(int device, uint16_t seq)
+{
+    return ((uint32_t)device << 16) | seq;
+}
+
+/*
+ * Distance from a row of gateway g at corrected ts to record r: to the
+ * nearest copy in r, corrected with the current offsets, less how far apart
+ * two copies of one sample may land. That allowance is a few times the
+ * measured jitter of both gateways, or MATCH_COLD_MS while either clock
+ * offset is still unknown. Negative if the row may be a copy of r.
+ */
+int64_t match_distance(size_t g, int64_t ts, const record_t &r)
+{
+    const source_t &src = g_sources[g];
+    int64_t best = INT64_MAX;
+
+    for (size_t h = 0; h < g_sources.size(); h++) {
+        const source_t &other = g_sources[h];
+        if (r.raw_ts[h] == INT64_MIN) {
+            continue;
+        }
+        int64_t allow = MATCH_COLD_MS;
+        if (src.offset_ready && other.offset_ready) {
+            allow = MATCH_MIN_MS +
+                    (int64_t)(MATCH_JITTER_K * (src.jitter_ms + other.jitter_ms));
+        }
+        best = std::min<int64_t>(best, std::llabs(ts - corrected_ts(other, r.raw_ts[h])) - allow);
+    }
+    return best;
+}
+
+/*
+ * A row is a copy of the record with the same device and seq whose corrected
+ * ts is nearest, among those within match_distance() that gateway g has not
+ * delivered yet. seq alone cannot tell them apart: a TX that reboots repeats
+ * its seq numbers, in the forest capture three times within six seconds, and
+ * every gateway loses different rows around the reboot. Returns 0 if none
+ * matches; *dup is set if g already delivered this very row.
+ */
+uint64_t find_record(size_t g, int device, const rx_row_t &row, int64_t ts, bool *dup)
+{
+    auto range = g_by_seq.equal_range(seq_key(device, row.seq));
+    uint64_t best = 0;
+    int64_t best_dist = INT64_MAX;
+
+    *dup = false;
+    for (auto it = range.first; it != range.second; ++it) {
+        const record_t &r = g_records.at(it->second);
+        if (r.raw_ts[g] != INT64_MIN) {
+            *dup = *dup || r.raw_ts[g] == row.ts_ms;
+            continue;
+        }
+        int64_t dist = match_distance(g, ts, r);
+        if (dist <= 0 && dist < best_dist) {
+            best = it->second;
+            best_dist = dist;
+        }
+    }
+    return best;
+}
+
+void drop_record(uint64_t id)
+{
+    const record_t &r = g_records.at(id);
+    auto range = g_by_seq.equal_range(seq_key(r.device, r.seq));
+
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == id) {
+            g_by_seq.erase(it);
+            break;
+        }
+    }
+    g_records.erase(id);
+}
+
+void emit(const record_t &r)
+{
+    char ts_buf[RX_CSV_TS_BUF];
+    int8_t best = RX_CSV_RSSI_UNKNOWN;
+
+    for (int8_t rssi : r.rssi) {
+        if (rssi != RX_CSV_RSSI_UNKNOWN && (best == RX_CSV_RSSI_UNKNOWN || rssi > best)) {
+            best = rssi;
+        }
+    }
+    rx_csv_format_ts(r.ts, ts_buf);
+    printf("%s,%s,%u,%s,%d", ts_buf, g_devices[r.device].c_str(),
+           (unsigned)r.seq, r.fields.c_str(), best);
+    if (g_opts.per_gateway) {
+        for (int8_t rssi : r.rssi) {
+            if (rssi == RX_CSV_RSSI_UNKNOWN) {
+                fputs(",", stdout);
+            } else {
+                printf(",%d", rssi);
+            }
+        }
+    }
+    fputc('\n', stdout);
+    g_stats.emitted++;
+}
+
+/*
+ * Emitted records stay findable for RETAIN_MS so that copies arriving after
+ * them count as late instead of turning into new records.
+ */
+void emit_oldest(void)
+{
+    auto first = g_order.begin();
+    uint64_t id = first->second;
+    record_t &r = g_records.at(id);
+
+    emit(r);
+    r.emitted = true;
+    r.fields.clear();
+    r.fields.shrink_to_fit();
+    g_order.erase(first);
+    g_frontier = std::max(g_frontier, r.ts);
+    g_retired.push_back(id);
+
+    while (!g_retired.empty() &&
+           g_records.at(g_retired.front()).ts < g_frontier - RETAIN_MS) {
+        drop_record(g_retired.front());
+        g_retired.pop_front();
+    }
+}
+
+void ingest(size_t g, const rx_row_t &row)
+{
+    source_t &src = g_sources[g];
+    int device = device_id(row.device);
+    int64_t ts = corrected_ts(src, row.ts_ms);
+    bool dup;
+    uint64_t id = find_record(g, device, row, ts, &dup);
+
+    src.rows++;
+    src.last_ts = std::max(src.last_ts, row.ts_ms);
+    src.last_wall_ms = mono_ms();
+
+    if (id == 0) {
+        if (dup) {
+            src.dups++;
+            return;
+        }
+        if (ts <= g_frontier) {
+            src.dropped++;
+            return;
+        }
+        record_t r;
+        r.ts = ts;
+        r.device = device;
+        r.seq = row.seq;
+        r.fields = row.fields;
+        r.raw_ts.assign(g_sources.size(), INT64_MIN);
+        r.rssi.assign(g_sources.size(), RX_CSV_RSSI_UNKNOWN);
+        r.raw_ts[g] = row.ts_ms;
+        r.rssi[g] = row.rssi;
+        id = ++g_next_id;
+        g_records.emplace(id, std::move(r));
+        g_by_seq.emplace(seq_key(device, row.seq), id);
+        g_order.emplace(ts, id);
+        g_stats.pending_peak = std::max(g_stats.pending_peak, g_order.size());
+        return;
+    }
+
+    /* a late copy still measures the clock offset */
+    record_t &r = g_records.at(id);
+    r.raw_ts[g] = row.ts_ms;
+    r.rssi[g] = row.rssi;
+    offsets_from_pair(r, g);
+    if (r.emitted) {
+        src.late++;
+        return;
+    }
+    g_stats.merged++;
+
+    if (ts < r.ts) {
+        g_order.erase(order_key_t(r.ts, id));
+        r.ts = ts;
+        g_order.emplace(r.ts, id);
+    }
+}
+
+/*
+ * In follow mode, an input silent for --idle-ms stops holding the others
+ * back, whether it went quiet or never delivered a row at all.
+ */
+bool idle(const source_t &src, int64_t now)
+{
+    return g_opts.follow && now - src.last_wall_ms > g_opts.idle_ms;
+}
+
+/*
+ * How far an input has got in reference time. Until its offset is known its
+ * corrected ts may still be off by up to MATCH_COLD_MS, so count it as that
+ * far behind: otherwise its records would go out before the copies that
+ * reveal its offset arrive.
+ */
+int64_t position(const source_t &src)
+{
+    return corrected_ts(src, src.last_ts) - (src.offset_ready ? 0 : MATCH_COLD_MS);
+}
+
+/*
+ * Everything at or before the watermark can no longer gain a gateway: the
+ * slowest live input is past it by at least the lateness slack. Idle inputs
+ * are left out. While some offset is unknown, records may be timed up to
+ * MATCH_COLD_MS early, so the watermark stays that much further back.
+ */
+bool watermark(int64_t *out)
+{
+    int64_t now = mono_ms();
+    int64_t wm = INT64_MAX;
+    bool any = false;
+    bool cold = false;
+
+    for (const source_t &src : g_sources) {
+        if (!src.open || idle(src, now)) {
+            continue;
+        }
+        if (src.last_ts == INT64_MIN) {
+            return false;
+        }
+        wm = std::min(wm, position(src));
+        any = true;
+        cold = cold || !src.offset_ready;
+    }
+    if (!any) {
+        return false;
+    }
+    *out = wm - g_opts.lateness_ms - (cold ? MATCH_COLD_MS : 0);
+    return true;
+}
+
+/*
+ * The open, non-idle input that holds the watermark back: one that has not
+ * delivered a row yet, else the one with the oldest position(). -1 if none.
+ */
+int slowest_source(int64_t now)
+{
+    int slowest = -1;
+    int64_t slowest_ts = INT64_MAX;
+
+    for (size_t g = 0; g < g_sources.size(); g++) {
+        const source_t &src = g_sources[g];
+        if (!src.open || idle(src, now)) {
+            continue;
+        }
+        if (src.last_ts == INT64_MIN) {
+            return (int)g;
+        }
+        int64_t ts = position(src);
+        if (ts < slowest_ts) {
+            slowest = (int)g;
+            slowest_ts = ts;
+        }
+    }
+    return slowest;
+}
+
+/*
+ * Regular files are always readable, so reading them as fast as possible
+ * would just pile records up waiting for the slower inputs. Hold back any
+ * file that is already ahead of the slowest input, and at --max-pending
+ * every file but the slowest: only it can move the watermark.
+ */
+bool throttled(size_t g)
+{
+    const source_t &src = g_sources[g];
+    int s;
+
+    if (!src.regular || src.last_ts == INT64_MIN) {
+        return false;
+    }
+    s = slowest_source(mono_ms());
+    if (s < 0 || (size_t)s == g) {
+        return false;
+    }
+    const source_t &slow = g_sources[s];
+    if (slow.last_ts == INT64_MIN || g_order.size() >= g_opts.max_pending) {
+        return true;
+    }
+    return position(src) > position(slow) + std::max<int64_t>(g_opts.lateness_ms, 1000);
+}
+
+/*
+ * Emit everything up to the watermark. Past --max-pending, records are
+ * forced out ahead of it only while a live input holds the watermark back;
+ * files are throttled instead, see throttled().
+ */
+void flush(bool all)
+{
+    int64_t wm = INT64_MIN;
+    bool have_wm = !all && watermark(&wm);
+    int s = all ? -1 : slowest_source(mono_ms());
+    bool force = s >= 0 && !g_sources[s].regular;
+
+    while (!g_order.empty()) {
+        if (all || (have_wm && g_order.begin()->first <= wm)) {
+            emit_oldest();
+        } else if (force && g_order.size() > g_opts.max_pending) {
+            emit_oldest();
+            g_stats.forced++;
+        } else {
+            break;
+        }
+    }
+}
+
+/*
+ * Ingest the buffered lines of g until it gets throttled, emitting as the
+ * watermark moves so that pending records stay within --max-pending.
+ * Whatever is left stays buffered for the next call.
+ */
+void consume_lines(size_t g, bool all)
+{
+    source_t &src = g_sources[g];
+    size_t start = 0;
+    size_t nl;
+    rx_row_t row;
+
+    while ((all || !throttled(g)) &&
+           (nl = src.buf.find('\n', start)) != std::string::npos) {
+        if (rx_csv_parse_line(src.buf.data() + start, nl - start, &row) == 0) {
+            ingest(g, row);
+            if (!all && g_order.size() >= g_opts.max_pending) {
+                flush(false);
+            }
+        } else if (nl > start && src.buf[start] != '#' &&
+                   src.buf.compare(start, 3, "ts,") != 0) {
+            src.bad++;
+        }
+        start = nl + 1;
+    }
+    src.buf.erase(0, start);
+    if (src.buf.size() > LINE_MAX_LEN && src.buf.find('\n') == std::string::npos) {
+        src.buf.clear();
+        src.bad++;
+    }
+}
+
+void close_source(source_t &src)
+{
+    if (src.fd >= 0) {
+        close(src.fd);
+    }
+    src.fd = -1;
+    src.open = false;
+}
+
+/* Returns the number of bytes read, 0 at EOF, -1 if nothing was available. */
+ssize_t read_source(size_t g)
+{
+    source_t &src = g_sources[g];
+    char chunk[READ_CHUNK];
+    ssize_t n = read(src.fd, chunk, sizeof(chunk));
+
+    if (n > 0) {
+        src.buf.append(chunk, (size_t)n);
+        consume_lines(g, false);
+        return n;
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EINTR)) {
+        return -1;
+    }
+    if (n < 0 && errno != EIO) {
+        fprintf(stderr, "# MERGE: read %s failed: %s\n",
+                src.path.c_str(), strerror(errno));
+    }
+    return 0;
+}
+
+void run(void)
+{
+    std::vector<struct pollfd> pfds;
+    std::vector<size_t> pidx;
+
+    for (;;) {
+        bool progressed = false;
+        bool any_open = false;
+
+        pfds.clear();
+        pidx.clear();
+        for (size_t g = 0; g < g_sources.size(); g++) {
+            source_t &src = g_sources[g];
+            if (!src.open) {
+                continue;
+            }
+            any_open = true;
+            if (throttled(g)) {
+                continue;
+            }
+            if (!src.regular) {
+                pfds.push_back({ src.fd, POLLIN, 0 });
+                pidx.push_back(g);
+                continue;
+            }
+            if (src.buf.find('\n') != std::string::npos) {
+                consume_lines(g, false);    /* left over from a throttled read */
+                progressed = true;
+                continue;
+            }
+            ssize_t n = read_source(g);
+            if (n > 0) {
+                progressed = true;
+            } else if (n == 0 && !g_opts.follow) {
+                close_source(src);
+            }
+        }
+        if (!any_open || g_stop) {
+            break;
+        }
+
+        int timeout = progressed ? 0 : POLL_TIMEOUT_MS;
+        int rc = poll(pfds.data(), pfds.size(), timeout);
+        if (rc < 0 && errno != EINTR) {
+            perror("# MERGE: poll");
+            break;
+        }
+        for (size_t i = 0; rc > 0 && i < pfds.size(); i++) {
+            if (pfds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                if (read_source(pidx[i]) == 0) {
+                    close_source(g_sources[pidx[i]]);
+                }
+            }
+        }
+        flush(false);
+    }
+
+    for (size_t g = 0; g < g_sources.size(); g++) {
+        if (!g_sources[g].buf.empty()) {
+            g_sources[g].buf.push_back('\n');
+            consume_lines(g, true);
+        }
+        close_source(g_sources[g]);
+    }
+    flush(true);
+}
+
+int open_source(source_t &src)
+{
+    struct stat st;
+
+    src.fd = open(src.path.c_str(), O_RDONLY | O_NONBLOCK | O_NOCTTY);
+    if (src.fd < 0) {
+        fprintf(stderr, "# MERGE: cannot open %s: %s\n",
+                src.path.c_str(), strerror(errno));
+        return -1;
+    }
+    if (fstat(src.fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        src.regular = true;
+    }
+    src.open = true;
+    src.last_wall_ms = mono_ms();
+    return 0;
+}
+
+void print_stats(double elapsed_s)
+{
+    struct rusage ru;
+    uint64_t rows = 0;
+
+    for (const source_t &src : g_sources) {
+        fprintf(stderr,
+                "# MERGE: gw=%s rows=%llu bad=%llu dups=%llu late=%llu dropped=%llu "
+                "offset_ms=%.1f offset_samples=%llu\n",
+                src.name.c_str(), (unsigned long long)src.rows,
+                (unsigned long long)src.bad, (unsigned long long)src.dups,
+                (unsigned long long)src.late, (unsigned long long)src.dropped,
+                src.offset_ms,
+                (unsigned long long)src.offset_samples);
+        rows += src.rows;
+    }
+    getrusage(RUSAGE_SELF, &ru);
+    fprintf(stderr,
+            "# MERGE: rows_in=%llu emitted=%llu merged=%llu forced=%llu "
+            "pending_peak=%zu devices=%zu\n",
+            (unsigned long long)rows, (unsigned long long)g_stats.emitted,
+            (unsigned long long)g_stats.merged, (unsigned long long)g_stats.forced,
+            g_stats.pending_peak,
+            g_devices.size());
+    fprintf(stderr, "# MERGE: elapsed_s=%.3f rows_per_s=%.0f max_rss_kb=%ld\n",
+            elapsed_s, elapsed_s > 0 ? rows / elapsed_s : 0.0, ru.ru_maxrss);
+}
+
+void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options] [name=]rx.csv [[name=]rx.csv ...]\n"
+            "  -f              follow inputs (tail files, keep ptys open)\n"
+            "  -g              append one rssi_<name> column per gateway\n"
+            "  -l MS           lateness slack before emitting (default %lld)\n"
+            "  -i MS           idle input timeout in follow mode (default %lld)\n"
+            "  -p N            max pending records (default %zu)\n"
+            "  -s              print per-gateway and throughput stats to stderr\n",
+            prog, (long long)g_opts.lateness_ms, (long long)g_opts.idle_ms,
+            g_opts.max_pending);
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    int opt;
+
+    while ((opt = getopt(argc, argv, "fgl:i:p:sh")) != -1) {
+        switch (opt) {
+        case 'f':
+            g_opts.follow = true;
+            break;
+        case 'g':
+            g_opts.per_gateway = true;
+            break;
+        case 'l':
+            g_opts.lateness_ms = strtoll(optarg, NULL, 10);
+            break;
+        case 'i':
+            g_opts.idle_ms = strtoll(optarg, NULL, 10);
+            break;
+        case 'p':
+            g_opts.max_pending = strtoull(optarg, NULL, 10);
+            break;
+        case 's':
+            g_opts.stats = true;
+            break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (optind >= argc) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    for (int i = optind; i < argc; i++) {
+        source_t src;
+        const char *eq = strchr(argv[i], '=');
+        if (eq) {
+            src.name.assign(argv[i], eq - argv[i]);
+            src.path = eq + 1;
+        } else {
+            src.name = "gw" + std::to_string(i - optind);
+            src.path = argv[i];
+        }
+        g_sources.push_back(src);
+    }
+    g_sources[0].offset_ready = true;
+    for (source_t &src : g_sources) {
+        if (open_source(src) != 0) {
+            return 1;
+        }
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    if (g_opts.follow) {
+        setvbuf(stdout, NULL, _IOLBF, 0);
+    }
+    fputs(RX_CSV_HEADER, stdout);
+    if (g_opts.per_gateway) {
+        for (const source_t &src : g_sources) {
+            printf(",rssi_%s", src.name.c_str());
+        }
+    }
+    fputc('\n', stdout);
+
+    int64_t t0 = mono_ms();
+    run();
+    fflush(stdout);
+    if (g_opts.stats) {
+        print_stats((mono_ms() - t0) / 1000.0);
+    }
+    return 0;
+}
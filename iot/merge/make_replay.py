@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+"""Build a synthetic multi-gateway replay from a single-gateway rx.csv.
+
+Every gateway gets its own clock offset, timestamp jitter, per-device RSSI
+bias, packet loss and device coverage, so the merger has to align, offset-
+correct and deduplicate. --repeat extends the capture with continuing seq
+numbers to exercise uint16 wraparound.
+"""
+import argparse
+import csv
+import os
+import random
+from datetime import datetime, timedelta
+
+TS_FMT = "%Y-%m-%d %H:%M:%S.%f"
+
+
+def load_rows(path):
+    rows = []
+    with open(path, newline="") as f:
+        reader = csv.reader(f)
+        header = next(reader)
+        for r in reader:
+            if len(r) != 10:
+                continue
+            rows.append((datetime.strptime(r[0], TS_FMT), r[1], int(r[2]), r[3:9], int(r[9])))
+    return header, rows
+
+
+def extend_rows(rows, repeat):
+    if repeat <= 1:
+        return rows
+    span = rows[-1][0] - rows[0][0] + timedelta(milliseconds=100)
+    seq_span = {}
+    for _, dev, seq, _, _ in rows:
+        lo, hi = seq_span.get(dev, (seq, seq))
+        seq_span[dev] = (min(lo, seq), max(hi, seq))
+    out = []
+    for k in range(repeat):
+        for ts, dev, seq, fields, rssi in rows:
+            lo, hi = seq_span[dev]
+            out.append((ts + k * span, dev, (seq + k * (hi - lo + 1)) & 0xFFFF, fields, rssi))
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("src", help="single-gateway rx.csv")
+    parser.add_argument("--out", required=True, help="output directory for gw*.csv")
+    parser.add_argument("--gateways", type=int, default=3)
+    parser.add_argument("--repeat", type=int, default=1)
+    parser.add_argument("--drop", type=float, default=0.1, help="per-record loss probability")
+    parser.add_argument("--coverage", type=float, default=0.75,
+                        help="probability that a gateway hears a given device")
+    parser.add_argument("--max_offset_ms", type=float, default=3000.0)
+    parser.add_argument("--jitter_ms", type=float, default=3.0)
+    parser.add_argument("--seed", type=int, default=0)
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    header, rows = load_rows(args.src)
+    rows = extend_rows(rows, args.repeat)
+    devices = sorted({r[1] for r in rows})
+
+    gateways = []
+    for g in range(args.gateways):
+        heard = {d for d in devices if rng.random() < args.coverage}
+        gateways.append({
+            "offset": timedelta(milliseconds=rng.uniform(-args.max_offset_ms, args.max_offset_ms)),
+            "heard": heard,
+            "bias": {d: rng.randint(-8, 8) for d in devices},
+        })
+    # Gateway 0 is the reference clock; every device must be heard somewhere.
+    gateways[0]["offset"] = timedelta(0)
+    for d in devices:
+        if not any(d in gw["heard"] for gw in gateways):
+            gateways[rng.randrange(args.gateways)]["heard"].add(d)
+
+    os.makedirs(args.out, exist_ok=True)
+    seen = set()
+    for g, gw in enumerate(gateways):
+        out_rows = []
+        prev_ts = None
+        for i, (ts, dev, seq, fields, rssi) in enumerate(rows):
+            if dev not in gw["heard"] or rng.random() < args.drop:
+                continue
+            # A gateway logs notifications in arrival order with a
+            # non-decreasing host timestamp, so jitter never reorders them.
+            jitter = timedelta(milliseconds=rng.gauss(0.0, args.jitter_ms))
+            ts_g = ts + gw["offset"] + jitter
+            if prev_ts is not None and ts_g < prev_ts:
+                ts_g = prev_ts
+            prev_ts = ts_g
+            rssi_g = max(-127, min(-1, rssi + gw["bias"][dev] + rng.randint(-2, 2)))
+            out_rows.append((ts_g, dev, seq, fields, rssi_g))
+            seen.add(i)
+
+        path = os.path.join(args.out, f"gw{g}.csv")
+        with open(path, "w", newline="") as f:
+            writer = csv.writer(f, lineterminator="\n")
+            writer.writerow(header)
+            for ts, dev, seq, fields, rssi in out_rows:
+                writer.writerow([ts.strftime(TS_FMT)[:-3], dev, seq, *fields, rssi])
+        print(f"# REPLAY: {path} rows={len(out_rows)} "
+              f"offset_ms={gw['offset'] / timedelta(milliseconds=1):.1f} "
+              f"devices={','.join(sorted(gw['heard']))}")
+
+    print(f"# REPLAY: source_rows={len(rows)} unique_heard={len(seen)}")
+
+
+if __name__ == "__main__":
+    main()
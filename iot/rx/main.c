@@ -1,6 +1,7 @@
 /*
  * BLE RX (central): scan, connect, subscribe, and print raw phydat values
- * received from TX as CSV lines.
+ * received from TX as CSV lines. The payload variant (payload.h) is fixed at
+ * build time and must match the TX build.
  */
 
 #include <assert.h>
@@ -15,6 +16,8 @@
 #include "services/gatt/ble_svc_gatt.h"
 #include "os/os_mbuf.h"
 
+#include "payload.h"
+
 #define CUSTOM_SVC_UUID     0xff00
 #define CUSTOM_CHR_UUID     0xee00
 #define DEVICE_NAME_PREFIX  "RIOT-BLE-"
@@ -31,16 +34,6 @@
 #define MAX_CONN            RX_MAX_CONN
 #endif
 
-typedef struct __attribute__((packed)) {
-    uint16_t seq;
-    int16_t temp_val;
-    int8_t temp_scale;
-    int16_t hum_val;
-    int8_t hum_scale;
-    int16_t press_val;
-    int8_t press_scale;
-} sample_t;
-
 static ble_uuid16_t g_svc_uuid = BLE_UUID16_INIT(CUSTOM_SVC_UUID);
 static ble_uuid16_t g_chr_uuid = BLE_UUID16_INIT(CUSTOM_CHR_UUID);
 
@@ -304,20 +297,13 @@ static int gap_event(struct ble_gap_event *event, void *arg)
 
     case BLE_GAP_EVENT_NOTIFY_RX: {
         uint16_t rx_len = event->notify_rx.om->om_len;
-        if (rx_len < sizeof(uint16_t)) {
+        if (rx_len < sizeof(sample_t)) {
             RX_LOG("# RX: short notify len=%u\n", (unsigned)rx_len);
             return 0;
         }
 
         sample_t sample;
-        memset(&sample, 0, sizeof(sample));
-        
-        if (rx_len >= sizeof(sample_t)) {
-            os_mbuf_copydata(event->notify_rx.om, 0, sizeof(sample), &sample);
-        } else {
-            // Minimal payload: just the sequence number
-            os_mbuf_copydata(event->notify_rx.om, 0, sizeof(uint16_t), &sample.seq);
-        }
+        os_mbuf_copydata(event->notify_rx.om, 0, sizeof(sample), &sample);
 
         if (!slot) {
             slot = find_slot_by_handle(event->notify_rx.conn_handle);
@@ -325,20 +311,9 @@ static int gap_event(struct ble_gap_event *event, void *arg)
         const char *dev_name = slot ? slot->name : "unknown";
 
         int8_t rssi = 127;  // 127 often used as "unknown/unavailable"
-        ble_gap_conn_rssi(event->notify_rx.conn_handle, &rssi); 
-        
-        if (rx_len >= sizeof(sample_t)) {
-            printf("%s,%u,%d,%d,%d,%d,%d,%d,%d\n",
-                   dev_name,
-                   sample.seq,
-                   sample.temp_val, sample.temp_scale,
-                   sample.hum_val, sample.hum_scale,
-                   sample.press_val, sample.press_scale, rssi);
-        } else {
-            printf("%s,%u,,,,,,,%d\n",
-                   dev_name,
-                   sample.seq, rssi);
-        }
+        ble_gap_conn_rssi(event->notify_rx.conn_handle, &rssi);
+
+        printf(PAYLOAD_CSV_FMT, dev_name, PAYLOAD_CSV_ARGS(sample), rssi);
 
         return 0;
     }
@@ -474,7 +449,7 @@ int main(void)
     rc = ble_hs_id_infer_auto(0, &g_addr_type);
     assert(rc == 0);
 
-    printf("device,seq,temp_val,temp_scale,hum_val,hum_scale,press_val,press_scale\n");
+    printf(PAYLOAD_CSV_HEADER);
 
     start_scan();
 
@@ -1,6 +1,7 @@
 /*
  * BLE TX (peripheral): read SHT humidity + BMP280 temperature/pressure via SAUL,
- * then notify the central at 10 Hz with raw phydat values (val + scale).
+ * then notify the central at 10 Hz with raw phydat values (val + scale). The
+ * payload variant (payload.h) is fixed at build time by ENABLE_SENSOR.
  */
 
 #include <assert.h>
@@ -16,43 +17,27 @@
 #include "os/os_mbuf.h"
 #include "saul_reg.h"
 
+#include "payload.h"
+
 #define CUSTOM_SVC_UUID     0xff00
 #define CUSTOM_CHR_UUID     0xee00
 #ifndef TX_DEVICE_NAME
 #define TX_DEVICE_NAME      "RIOT-IOT-0"
 #endif
 
-#ifndef ENABLE_SENSOR
-#define ENABLE_SENSOR       0
-#endif
-
-#define SHT_NAME            "sht3x1"
-#define BMP_NAME            "bmp280"
-
 #define SAMPLE_PERIOD_MS    100
 
-typedef struct __attribute__((packed)) {
-    uint16_t seq;
-    int16_t temp_val;
-    int8_t temp_scale;
-    int16_t hum_val;
-    int8_t hum_scale;
-    int16_t press_val;
-    int8_t press_scale;
-} sample_t;
-
 static uint8_t g_addr_type;
 static uint8_t g_conn_state;
 static uint8_t g_notify_state;
 static uint16_t g_conn_handle;
 static uint16_t g_notify_val_handle;
 
-#if ENABLE_SENSOR
-static saul_reg_t *g_temp_dev;
-static saul_reg_t *g_hum_dev;
-static saul_reg_t *g_press_dev;
-static uint8_t g_sensors_ready;
-#endif
+#define SENSOR_DEV(a, name, type, dev) static saul_reg_t *g_##name##_dev;
+PAYLOAD_FIELDS(SENSOR_DEV, _)
+#undef SENSOR_DEV
+/* Never cleared without sensors, so the check folds away */
+static uint8_t g_sensors_ready = 1;
 
 static void start_advertising(void);
 
@@ -67,6 +52,18 @@ static saul_reg_t *find_dev(uint8_t type, const char *name, const char *label)
 }
 #endif
 
+/* Look up the SAUL device of every payload sensor, e.g. "bmp280 temp" */
+static void find_sensors(void)
+{
+#define FIND_SENSOR(a, name, type, dev)                         \
+    g_##name##_dev = find_dev(type, dev, dev " " #name);        \
+    if (!g_##name##_dev) {                                      \
+        g_sensors_ready = 0;                                    \
+    }
+    PAYLOAD_FIELDS(FIND_SENSOR, _)
+#undef FIND_SENSOR
+}
+
 static int gatt_access_cb(uint16_t conn_handle, uint16_t attr_handle,
                           struct ble_gatt_access_ctxt *ctxt, void *arg)
 {
@@ -176,6 +173,42 @@ static void start_advertising(void)
     }
 }
 
+static void send_sample(uint16_t *seq)
+{
+    if (!(g_conn_state && g_notify_state && g_sensors_ready)) {
+        return;
+    }
+
+    sample_t sample;
+
+#define READ_SENSOR(s, name, type, dev)                         \
+    {                                                           \
+        phydat_t name;                                          \
+        if (saul_reg_read(g_##name##_dev, &name) < 1) {         \
+            printf("# TX: " #name " read failed\n");            \
+            return;                                             \
+        }                                                       \
+        (s).name##_val = name.val[0];                           \
+        (s).name##_scale = name.scale;                          \
+    }
+    PAYLOAD_FIELDS(READ_SENSOR, sample)
+#undef READ_SENSOR
+
+    sample.seq = (*seq)++;
+
+    struct os_mbuf *om = ble_hs_mbuf_from_flat(&sample, sizeof(sample));
+    if (om == NULL) {
+        printf("# TX: mbuf alloc failed\n");
+        return;
+    }
+
+    int rc = ble_gatts_notify_custom(g_conn_handle, g_notify_val_handle, om);
+    if (rc != 0) {
+        printf("# TX: notify failed rc=%d\n", rc);
+        os_mbuf_free_chain(om);
+    }
+}
+
 int main(void)
 {
     int rc = ble_svc_gap_device_name_set(TX_DEVICE_NAME);
@@ -188,14 +221,7 @@ int main(void)
     rc = ble_gatts_start();
     assert(rc == 0);
 
-    #if ENABLE_SENSOR
-        g_temp_dev = find_dev(SAUL_SENSE_TEMP, BMP_NAME, "bmp280 temp");
-        g_press_dev = find_dev(SAUL_SENSE_PRESS, BMP_NAME, "bmp280 press");
-        g_hum_dev = find_dev(SAUL_SENSE_HUM, SHT_NAME, "sht3x hum");
-        g_sensors_ready = (g_temp_dev && g_press_dev && g_hum_dev);
-    #else
-    /* No sensors to initialize */
-#endif
+    find_sensors();
 
     rc = ble_hs_util_ensure_addr(0);
     assert(rc == 0);
@@ -206,66 +232,7 @@ int main(void)
 
     uint16_t seq = 0;
     while (1) {
-    #if ENABLE_SENSOR
-        if (g_conn_state && g_notify_state && g_sensors_ready) {
-            phydat_t temp;
-            phydat_t hum;
-            phydat_t press;
-
-            if (saul_reg_read(g_temp_dev, &temp) < 1) {
-                printf("# TX: temp read failed\n");
-                goto sleep;
-            }
-            if (saul_reg_read(g_hum_dev, &hum) < 1) {
-                printf("# TX: hum read failed\n");
-                goto sleep;
-            }
-            if (saul_reg_read(g_press_dev, &press) < 1) {
-                printf("# TX: press read failed\n");
-                goto sleep;
-            }
-
-            sample_t sample = {
-                .seq = seq++,
-                .temp_val = temp.val[0],
-                .temp_scale = temp.scale,
-                .hum_val = hum.val[0],
-                .hum_scale = hum.scale,
-                .press_val = press.val[0],
-                .press_scale = press.scale,
-            };
-
-            struct os_mbuf *om = ble_hs_mbuf_from_flat(&sample, sizeof(sample));
-            if (om == NULL) {
-                printf("# TX: mbuf alloc failed\n");
-                goto sleep;
-            }
-
-            int rc = ble_gatts_notify_custom(g_conn_handle, g_notify_val_handle, om);
-            if (rc != 0) {
-                printf("# TX: notify failed rc=%d\n", rc);
-                os_mbuf_free_chain(om);
-            }
-        }
-    #else
-        if (g_conn_state && g_notify_state) {
-            uint16_t minimal_payload = seq++;
-            
-            struct os_mbuf *om = ble_hs_mbuf_from_flat(&minimal_payload, sizeof(minimal_payload));
-            if (om == NULL) {
-                printf("# TX: mbuf alloc failed\n");
-                goto sleep;
-            }
-
-            int rc = ble_gatts_notify_custom(g_conn_handle, g_notify_val_handle, om);
-            if (rc != 0) {
-                printf("# TX: notify failed rc=%d\n", rc);
-                os_mbuf_free_chain(om);
-            }
-        }
-    #endif
-
-    sleep:
+        send_sample(&seq);
         ztimer_sleep(ZTIMER_MSEC, SAMPLE_PERIOD_MS);
     }
 
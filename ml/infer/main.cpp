@@ -0,0 +1,576 @@
+/*
+ * Real-time classification daemon (host): tail an rx.csv stream (file, FIFO,
+ * pty or stdin), rebuild the per-device feature windows the same way as
+ * src/prepare_data.py, and classify them with the weights exported by
+ * src/export_model.py. Ready windows of all devices are forwarded together
+ * as one batch.
+ *
+ *   infer_daemon -m model.bin [-f] [-t threads] [-b batch] [-n lo,hi] [rx.csv|-]
+ *   infer_daemon -m model.bin -r /dev/ttyACM0   (raw RX serial output)
+ *   infer_daemon -m model.bin -P parity.bin     (compare with exported logits)
+ *   infer_daemon -m model.bin -B windows        (kernel throughput)
+ *
+ * One CSV line per prediction goes to stdout:
+ *   ts,device,pred,label,confidence,latency_us
+ * where latency_us runs from reading the window's newest sample to publishing.
+ *
+ * rx.csv input carries the ts column added by log_rx.sh. With -r, the input
+ * is the RX firmware's own output (the serial port, or `make term` on stdin):
+ * lines without ts, which are stamped with the local arrival time instead.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "model.hpp"
+#include "rx_csv.h"
+
+#define READ_CHUNK          (64 * 1024)
+#define LINE_MAX_LEN        256
+#define POLL_TIMEOUT_MS     50
+#define HIST_BUCKETS        256
+#define HIST_STEPS_PER_2X   8
+
+namespace {
+
+typedef std::chrono::steady_clock clock_type;
+
+struct options_t {
+    std::string model_path;
+    std::string input = "-";
+    std::string parity_path;
+    int bench_windows = 0;
+    int threads = 0;
+    int max_batch = 64;
+    bool follow = false;
+    bool raw = false;
+    bool fixed_norm = false;
+    float norm_lo = 0.0f;
+    float norm_hi = 1.0f;
+};
+
+/* Per-device feature state: the rssi_diff / latency series and its ring. */
+struct device_state_t {
+    std::string name;
+    bool have_prev = false;
+    int64_t prev_ts = 0;
+    int prev_rssi = 0;
+    std::vector<float> ring;
+    uint64_t n = 0;
+    float lo = INFINITY;
+    float hi = -INFINITY;
+};
+
+struct window_t {
+    int device;
+    int64_t ts_ms;
+    clock_type::time_point arrival;
+};
+
+/* Log-scale latency histogram, 1 us resolution at the low end. */
+struct latency_hist_t {
+    uint64_t counts[HIST_BUCKETS] = {0};
+    uint64_t total = 0;
+    double max_us = 0.0;
+
+    static int bucket(double us)
+    {
+        if (us < 1.0) {
+            return 0;
+        }
+        int b = 1 + (int)(std::log2(us) * HIST_STEPS_PER_2X);
+        return std::min(b, HIST_BUCKETS - 1);
+    }
+
+    void add(double us)
+    {
+        counts[bucket(us)]++;
+        total++;
+        max_us = std::max(max_us, us);
+    }
+
+    double quantile(double q) const
+    {
+        uint64_t target = (uint64_t)std::ceil(q * total);
+        uint64_t seen = 0;
+        for (int b = 0; b < HIST_BUCKETS; b++) {
+            seen += counts[b];
+            if (seen >= target && seen > 0) {
+                return std::min(max_us, std::exp2((double)b / HIST_STEPS_PER_2X));
+            }
+        }
+        return max_us;
+    }
+};
+
+options_t g_opts;
+model_t g_model;
+std::vector<device_state_t> g_devices;
+std::unordered_map<std::string, int> g_device_ids;
+std::vector<window_t> g_pending;
+std::vector<float> g_batch_x;
+std::vector<float> g_batch_logits;
+latency_hist_t g_latency;
+uint64_t g_rows;
+uint64_t g_bad;
+uint64_t g_windows;
+uint64_t g_batches;
+double g_forward_s;
+volatile sig_atomic_t g_stop;
+
+void on_signal(int sig)
+{
+    (void)sig;
+    g_stop = 1;
+}
+
+double seconds_since(clock_type::time_point t0)
+{
+    return std::chrono::duration<double>(clock_type::now() - t0).count();
+}
+
+int device_id(const char *name)
+{
+    auto it = g_device_ids.find(name);
+    if (it != g_device_ids.end()) {
+        return it->second;
+    }
+    int id = (int)g_devices.size();
+    g_devices.emplace_back();
+    g_devices.back().name = name;
+    g_devices.back().ring.assign(g_model.seq_len, 0.0f);
+    g_device_ids.emplace(name, id);
+    return id;
+}
+
+void publish(thread_pool_t &pool)
+{
+    const int n = (int)g_pending.size();
+    const int c = g_model.num_classes;
+    std::vector<float> probs(c);
+
+    if (n == 0) {
+        return;
+    }
+    g_batch_logits.resize((size_t)n * c);
+    auto t0 = clock_type::now();
+    model_forward(g_model, pool, g_batch_x.data(), n, g_batch_logits.data());
+    g_forward_s += seconds_since(t0);
+
+    for (int i = 0; i < n; i++) {
+        const window_t &w = g_pending[i];
+        const float *logits = g_batch_logits.data() + (size_t)i * c;
+        char ts_buf[RX_CSV_TS_BUF];
+
+        softmax(logits, c, probs.data());
+        int pred = (int)(std::max_element(probs.begin(), probs.end()) - probs.begin());
+        double latency_us = seconds_since(w.arrival) * 1e6;
+        rx_csv_format_ts(w.ts_ms, ts_buf);
+        printf("%s,%s,%d,%s,%.4f,%.0f\n", ts_buf, g_devices[w.device].name.c_str(),
+               pred, g_model.labels[pred].c_str(), probs[pred], latency_us);
+        g_latency.add(latency_us);
+    }
+    if (g_opts.follow) {
+        fflush(stdout);
+    }
+    g_windows += n;
+    g_batches++;
+    g_pending.clear();
+    g_batch_x.clear();
+}
+
+/*
+ * Extend the device's feature series by one sample. Windows start every
+ * `stride` features once seq_len are available, matching the offline
+ * range(0, len - seq_len + 1, stride) loop.
+ */
+void ingest(const rx_row_t &row, clock_type::time_point arrival, thread_pool_t &pool)
+{
+    device_state_t &dev = g_devices[device_id(row.device)];
+    float v;
+
+    g_rows++;
+    if (!dev.have_prev) {
+        dev.have_prev = true;
+        dev.prev_ts = row.ts_ms;
+        dev.prev_rssi = row.rssi;
+        return;
+    }
+    if (g_model.feature == FEATURE_LATENCY) {
+        v = (float)(row.ts_ms - dev.prev_ts) / 1000.0f;
+    } else {
+        v = (float)(row.rssi - dev.prev_rssi);
+    }
+    dev.prev_ts = row.ts_ms;
+    dev.prev_rssi = row.rssi;
+
+    const size_t len = (size_t)g_model.seq_len;
+    dev.ring[dev.n % len] = v;
+    dev.n++;
+    dev.lo = std::min(dev.lo, v);
+    dev.hi = std::max(dev.hi, v);
+
+    if (dev.n < len || (dev.n - len) % (uint64_t)g_model.stride != 0) {
+        return;
+    }
+    float lo = g_opts.fixed_norm ? g_opts.norm_lo : dev.lo;
+    float hi = g_opts.fixed_norm ? g_opts.norm_hi : dev.hi;
+    if (hi - lo == 0.0f) {
+        return;
+    }
+
+    const float scale = 1.0f / (hi - lo);
+    const size_t head = dev.n % len;    /* oldest feature in the ring */
+    const size_t base = g_batch_x.size();
+    g_batch_x.resize(base + len);
+    for (size_t i = 0; i < len; i++) {
+        g_batch_x[base + i] = (dev.ring[(head + i) % len] - lo) * scale;
+    }
+    g_pending.push_back(window_t{ (int)(&dev - g_devices.data()), row.ts_ms, arrival });
+    if ((int)g_pending.size() >= g_opts.max_batch) {
+        publish(pool);
+    }
+}
+
+/* Wall clock in local time, the clock log_rx.sh stamps rx.csv with */
+int64_t local_now_ms(void)
+{
+    struct timespec now;
+    struct tm tm;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    localtime_r(&now.tv_sec, &tm);
+    return ((int64_t)now.tv_sec + tm.tm_gmtoff) * 1000 + now.tv_nsec / 1000000;
+}
+
+/*
+ * Parse one line of raw RX output (-r): optionally behind the "<ts> # "
+ * prefix of `make term`, without the ts column. Returns 0 for a row, 1 for
+ * console messages to skip (boot banner, "#" logs), -1 for a malformed row.
+ */
+int parse_raw_line(const char *line, size_t len, const char *ts, rx_row_t *row)
+{
+    char full[RX_CSV_TS_BUF + LINE_MAX_LEN];
+    const char *sep = (const char *)memmem(line, len, " # ", 3);
+    size_t ts_len = strlen(ts);
+
+    if (sep) {
+        len -= (size_t)(sep + 3 - line);
+        line = sep + 3;
+    }
+    if (len == 0 || line[0] == '#' || std::count(line, line + len, ',') != 8) {
+        return 1;
+    }
+    if (ts_len + 1 + len > sizeof(full)) {
+        return -1;
+    }
+    memcpy(full, ts, ts_len);
+    full[ts_len] = ',';
+    memcpy(full + ts_len + 1, line, len);
+    return rx_csv_parse_line(full, ts_len + 1 + len, row) == 0 ? 0 : -1;
+}
+
+void consume_lines(std::string &buf, thread_pool_t &pool)
+{
+    const auto arrival = clock_type::now();
+    char ts[RX_CSV_TS_BUF];
+    size_t start = 0;
+    size_t nl;
+    rx_row_t row;
+
+    if (g_opts.raw) {
+        rx_csv_format_ts(local_now_ms(), ts);
+    }
+    while ((nl = buf.find('\n', start)) != std::string::npos) {
+        const char *line = buf.data() + start;
+        const size_t len = nl - start;
+
+        if (g_opts.raw) {
+            int rc = parse_raw_line(line, len, ts, &row);
+            if (rc == 0) {
+                ingest(row, arrival, pool);
+            } else if (rc < 0) {
+                g_bad++;
+            }
+        } else if (rx_csv_parse_line(line, len, &row) == 0) {
+            ingest(row, arrival, pool);
+        } else if (len > 0 && line[0] != '#' && buf.compare(start, 3, "ts,") != 0) {
+            g_bad++;
+        }
+        start = nl + 1;
+    }
+    buf.erase(0, start);
+    if (buf.size() > LINE_MAX_LEN) {
+        buf.clear();
+        g_bad++;
+    }
+}
+
+/* Serial port: raw bytes at the RX console baud rate, as log_rx.sh uses it */
+void setup_tty(int fd)
+{
+    struct termios tio;
+
+    if (tcgetattr(fd, &tio) != 0) {
+        return;
+    }
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, B115200);
+    cfsetospeed(&tio, B115200);
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+        fprintf(stderr, "# INFER: cannot configure %s: %s\n",
+                g_opts.input.c_str(), strerror(errno));
+    }
+}
+
+int run_stream(thread_pool_t &pool)
+{
+    int fd = STDIN_FILENO;
+    struct stat st;
+    std::string buf;
+    char chunk[READ_CHUNK];
+
+    if (g_opts.input != "-") {
+        fd = open(g_opts.input.c_str(), O_RDONLY | O_NONBLOCK | O_NOCTTY);
+        if (fd < 0) {
+            fprintf(stderr, "# INFER: cannot open %s: %s\n",
+                    g_opts.input.c_str(), strerror(errno));
+            return 1;
+        }
+        if (isatty(fd)) {
+            setup_tty(fd);
+        }
+    }
+    bool regular = fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+
+    printf("ts,device,pred,label,confidence,latency_us\n");
+    while (!g_stop) {
+        ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n > 0) {
+            buf.append(chunk, (size_t)n);
+            consume_lines(buf, pool);
+            if (n == (ssize_t)sizeof(chunk)) {
+                continue;
+            }
+            /* Input drained for now: do not hold ready windows back. */
+            publish(pool);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        publish(pool);
+        if (n == 0 && (!g_opts.follow || !regular)) {
+            break;
+        }
+        if (n < 0 && errno != EAGAIN) {
+            if (errno != EIO) {
+                fprintf(stderr, "# INFER: read failed: %s\n", strerror(errno));
+            }
+            break;
+        }
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        poll(regular ? nullptr : &pfd, regular ? 0 : 1, POLL_TIMEOUT_MS);
+    }
+    if (!buf.empty()) {
+        buf.push_back('\n');
+        consume_lines(buf, pool);
+    }
+    publish(pool);
+    if (fd != STDIN_FILENO) {
+        close(fd);
+    }
+
+    fprintf(stderr,
+            "# INFER: rows=%llu bad=%llu windows=%llu batches=%llu avg_batch=%.1f "
+            "forward_windows_per_s=%.0f\n",
+            (unsigned long long)g_rows, (unsigned long long)g_bad,
+            (unsigned long long)g_windows, (unsigned long long)g_batches,
+            g_batches ? (double)g_windows / g_batches : 0.0,
+            g_forward_s > 0 ? g_windows / g_forward_s : 0.0);
+    fprintf(stderr,
+            "# INFER: latency_us p50=%.0f p95=%.0f p99=%.0f max=%.0f\n",
+            g_latency.quantile(0.50), g_latency.quantile(0.95),
+            g_latency.quantile(0.99), g_latency.max_us);
+    return 0;
+}
+
+int run_parity(thread_pool_t &pool)
+{
+    std::ifstream f(g_opts.parity_path, std::ios::binary);
+    uint32_t hdr[3];
+
+    if (!f.read((char *)hdr, sizeof(hdr))) {
+        fprintf(stderr, "# INFER: cannot read %s\n", g_opts.parity_path.c_str());
+        return 1;
+    }
+    const int n = (int)hdr[0];
+    if ((int)hdr[1] != g_model.seq_len || (int)hdr[2] != g_model.num_classes) {
+        fprintf(stderr, "# INFER: parity file does not match the model\n");
+        return 1;
+    }
+    std::vector<float> x((size_t)n * g_model.seq_len);
+    std::vector<float> expect((size_t)n * g_model.num_classes);
+    std::vector<float> got(expect.size());
+    if (!f.read((char *)x.data(), x.size() * sizeof(float)) ||
+        !f.read((char *)expect.data(), expect.size() * sizeof(float))) {
+        fprintf(stderr, "# INFER: truncated parity file\n");
+        return 1;
+    }
+
+    model_forward(g_model, pool, x.data(), n, got.data());
+
+    const int c = g_model.num_classes;
+    double max_diff = 0.0;
+    int agree = 0;
+    for (int i = 0; i < n; i++) {
+        const float *e = expect.data() + (size_t)i * c;
+        const float *g = got.data() + (size_t)i * c;
+        for (int j = 0; j < c; j++) {
+            max_diff = std::max(max_diff, (double)std::fabs(e[j] - g[j]));
+        }
+        agree += std::max_element(e, e + c) - e == std::max_element(g, g + c) - g;
+    }
+    printf("# INFER: parity windows=%d max_abs_diff=%.3g argmax_agree=%d/%d\n",
+           n, max_diff, agree, n);
+    return max_diff < 1e-3 && agree == n ? 0 : 1;
+}
+
+int run_bench(thread_pool_t &pool)
+{
+    const int n = g_opts.bench_windows;
+    std::vector<float> x((size_t)n * g_model.seq_len);
+    std::vector<float> logits((size_t)n * g_model.num_classes);
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+
+    for (float &v : x) {
+        v = dist(rng);
+    }
+    model_forward(g_model, pool, x.data(), std::min(n, pool.size()), logits.data());
+
+    for (int batch = 1; batch <= n; batch *= 4) {
+        auto t0 = clock_type::now();
+        int done = 0;
+        int calls = 0;
+        while (done < n) {
+            int m = std::min(batch, n - done);
+            model_forward(g_model, pool, x.data() + (size_t)done * g_model.seq_len, m,
+                          logits.data() + (size_t)done * g_model.num_classes);
+            done += m;
+            calls++;
+        }
+        double s = seconds_since(t0);
+        printf("# INFER: bench seq_len=%d batch=%d threads=%d windows_per_s=%.0f "
+               "batch_latency_us=%.1f\n",
+               g_model.seq_len, batch, pool.size(), n / s, s / calls * 1e6);
+    }
+    return 0;
+}
+
+void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s -m model.bin [options] [rx.csv|-]\n"
+            "  -f              follow the input (tail a growing rx.csv)\n"
+            "  -r              raw RX output without ts (serial port, `make term`),\n"
+            "                  stamped with the arrival time\n"
+            "  -t N            forward threads (default: hardware concurrency)\n"
+            "  -b N            max windows per forward batch (default %d)\n"
+            "  -n LO,HI        fixed feature range instead of running per-device min/max\n"
+            "  -P parity.bin   compare against the logits written by\n"
+            "                  export_model.py --parity and exit\n"
+            "  -B N            benchmark the forward pass on N random windows and exit\n",
+            prog, g_opts.max_batch);
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    int opt;
+
+    while ((opt = getopt(argc, argv, "m:frt:b:n:P:B:h")) != -1) {
+        switch (opt) {
+        case 'm':
+            g_opts.model_path = optarg;
+            break;
+        case 'f':
+            g_opts.follow = true;
+            break;
+        case 'r':
+            g_opts.raw = true;
+            break;
+        case 't':
+            g_opts.threads = atoi(optarg);
+            break;
+        case 'b':
+            g_opts.max_batch = std::max(1, atoi(optarg));
+            break;
+        case 'n':
+            if (sscanf(optarg, "%f,%f", &g_opts.norm_lo, &g_opts.norm_hi) != 2 ||
+                g_opts.norm_hi <= g_opts.norm_lo) {
+                usage(argv[0]);
+                return 2;
+            }
+            g_opts.fixed_norm = true;
+            break;
+        case 'P':
+            g_opts.parity_path = optarg;
+            break;
+        case 'B':
+            g_opts.bench_windows = atoi(optarg);
+            break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (g_opts.model_path.empty()) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (optind < argc) {
+        g_opts.input = argv[optind];
+    }
+
+    std::string err = model_load(g_opts.model_path, g_model);
+    if (!err.empty()) {
+        fprintf(stderr, "# INFER: %s\n", err.c_str());
+        return 1;
+    }
+    if (g_opts.threads <= 0) {
+        g_opts.threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    }
+    thread_pool_t pool(g_opts.threads);
+
+    if (!g_opts.parity_path.empty()) {
+        return run_parity(pool);
+    }
+    if (g_opts.bench_windows > 0) {
+        return run_bench(pool);
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    return run_stream(pool);
+}
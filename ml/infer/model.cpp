@@ -0,0 +1,467 @@
+/*
+ * Weight loading, conv1d / pooling / linear kernels and the batch thread pool.
+ *
+ * Activations are kept channel-major with MARGIN zero floats on both sides of
+ * every row, so the convolutions need no border checks and can always process
+ * full LANES-wide tiles; whatever spills into the right margin is cleared again.
+ */
+
+#include "model.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define INFER_AVX2 1
+#else
+#define INFER_AVX2 0
+#endif
+
+#define MARGIN      32
+#define LANES       16
+#define CO_BLOCK    4
+
+namespace {
+
+struct reader_t {
+    const char *p;
+    const char *end;
+    bool ok = true;
+
+    uint32_t u32()
+    {
+        uint32_t v = 0;
+        if (end - p < 4) {
+            ok = false;
+            return 0;
+        }
+        memcpy(&v, p, 4);
+        p += 4;
+        return v;
+    }
+
+    void f32(std::vector<float> &out, size_t n)
+    {
+        if ((size_t)(end - p) < n * sizeof(float)) {
+            ok = false;
+            return;
+        }
+        out.resize(n);
+        memcpy(out.data(), p, n * sizeof(float));
+        p += n * sizeof(float);
+    }
+};
+
+struct act_t {
+    float *data;            /* row 0, first valid element */
+    int c;
+    int len;
+    int ld;
+};
+
+struct scratch_t {
+    std::vector<float> buf[3];
+    std::vector<float> vec[2];
+};
+
+thread_local scratch_t t_scratch;
+
+float *row(const act_t &a, int r)
+{
+    return a.data + (size_t)r * a.ld;
+}
+
+act_t make_act(std::vector<float> &buf, int c, int len, int ld)
+{
+    size_t need = (size_t)c * ld + 2 * MARGIN;
+    if (buf.size() < need) {
+        buf.assign(need, 0.0f);
+    }
+    return act_t{ buf.data() + MARGIN, c, len, ld };
+}
+
+void clear_right_margin(const act_t &a)
+{
+    for (int r = 0; r < a.c; r++) {
+        memset(row(a, r) + a.len, 0, (size_t)(a.ld - a.len) * sizeof(float));
+    }
+}
+
+/*
+ * Same-padded conv1d over a CO_BLOCK x LANES output tile: each input vector
+ * load is reused by CO_BLOCK output channels, the weights are broadcast.
+ */
+void conv1d(const op_t &op, const act_t &in, const act_t &out)
+{
+    const int cin = op.in;
+    const int k = op.k;
+    const int wstride = cin * k;
+
+    for (int co = 0; co < op.out; co += CO_BLOCK) {
+        const int nb = std::min(CO_BLOCK, op.out - co);
+        for (int t0 = 0; t0 < in.len; t0 += LANES) {
+#if INFER_AVX2
+            __m256 lo[CO_BLOCK];
+            __m256 hi[CO_BLOCK];
+            for (int j = 0; j < nb; j++) {
+                lo[j] = hi[j] = _mm256_set1_ps(op.b[co + j]);
+            }
+            for (int ci = 0; ci < cin; ci++) {
+                const float *x = row(in, ci) + t0 - op.pad;
+                const float *w = op.w.data() + (size_t)co * wstride + ci * k;
+                for (int kk = 0; kk < k; kk++) {
+                    __m256 xlo = _mm256_loadu_ps(x + kk);
+                    __m256 xhi = _mm256_loadu_ps(x + kk + 8);
+                    for (int j = 0; j < nb; j++) {
+                        __m256 wv = _mm256_broadcast_ss(w + j * wstride + kk);
+                        lo[j] = _mm256_fmadd_ps(wv, xlo, lo[j]);
+                        hi[j] = _mm256_fmadd_ps(wv, xhi, hi[j]);
+                    }
+                }
+            }
+            for (int j = 0; j < nb; j++) {
+                if (op.relu) {
+                    lo[j] = _mm256_max_ps(lo[j], _mm256_setzero_ps());
+                    hi[j] = _mm256_max_ps(hi[j], _mm256_setzero_ps());
+                }
+                _mm256_storeu_ps(row(out, co + j) + t0, lo[j]);
+                _mm256_storeu_ps(row(out, co + j) + t0 + 8, hi[j]);
+            }
+#else
+            float acc[CO_BLOCK][LANES];
+            for (int j = 0; j < nb; j++) {
+                for (int l = 0; l < LANES; l++) {
+                    acc[j][l] = op.b[co + j];
+                }
+            }
+            for (int ci = 0; ci < cin; ci++) {
+                const float *x = row(in, ci) + t0 - op.pad;
+                const float *w = op.w.data() + (size_t)co * wstride + ci * k;
+                for (int kk = 0; kk < k; kk++) {
+                    for (int j = 0; j < nb; j++) {
+                        const float wv = w[j * wstride + kk];
+                        for (int l = 0; l < LANES; l++) {
+                            acc[j][l] += wv * x[kk + l];
+                        }
+                    }
+                }
+            }
+            for (int j = 0; j < nb; j++) {
+                float *o = row(out, co + j) + t0;
+                for (int l = 0; l < LANES; l++) {
+                    o[l] = op.relu ? std::max(acc[j][l], 0.0f) : acc[j][l];
+                }
+            }
+#endif
+        }
+    }
+    clear_right_margin(out);
+}
+
+void maxpool(int k, const act_t &in, const act_t &out)
+{
+    for (int r = 0; r < in.c; r++) {
+        const float *x = row(in, r);
+        float *o = row(out, r);
+        for (int t = 0; t < out.len; t++) {
+            float m = x[t * k];
+            for (int j = 1; j < k; j++) {
+                m = std::max(m, x[t * k + j]);
+            }
+            o[t] = m;
+        }
+    }
+    clear_right_margin(out);
+}
+
+void residual_add(const act_t &acc, const act_t &identity)
+{
+    for (int r = 0; r < acc.c; r++) {
+        float *o = row(acc, r);
+        const float *x = row(identity, r);
+        for (int t = 0; t < acc.len; t++) {
+            o[t] = std::max(o[t] + x[t], 0.0f);
+        }
+    }
+}
+
+void linear(const op_t &op, const float *x, float *out)
+{
+    for (int o = 0; o < op.out; o++) {
+        const float *w = op.w.data() + (size_t)o * op.in;
+        float s = 0.0f;
+        for (int i = 0; i < op.in; i++) {
+            s += w[i] * x[i];
+        }
+        s += op.b[o];
+        out[o] = op.relu ? std::max(s, 0.0f) : s;
+    }
+}
+
+int free_buf(int a, int b)
+{
+    for (int i = 0; i < 3; i++) {
+        if (i != a && i != b) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void forward_one(const model_t &model, const float *x, float *logits)
+{
+    scratch_t &s = t_scratch;
+    const int ld = model.seq_len + 2 * MARGIN;
+    int cur = 0;
+    int identity = -1;
+    int vec = -1;
+
+    act_t a = make_act(s.buf[cur], 1, model.seq_len, ld);
+    memcpy(a.data, x, (size_t)model.seq_len * sizeof(float));
+    clear_right_margin(a);
+
+    for (const op_t &op : model.ops) {
+        switch (op.type) {
+        case OP_CONV: {
+            int next = free_buf(cur, identity);
+            act_t o = make_act(s.buf[next], op.out, a.len, ld);
+            conv1d(op, a, o);
+            a = o;
+            cur = next;
+            break;
+        }
+        case OP_MAXPOOL: {
+            int next = free_buf(cur, identity);
+            act_t o = make_act(s.buf[next], a.c, a.len / op.k, ld);
+            maxpool(op.k, a, o);
+            a = o;
+            cur = next;
+            break;
+        }
+        case OP_RES_BEGIN:
+            identity = cur;
+            break;
+        case OP_RES_END:
+            residual_add(a, act_t{ s.buf[identity].data() + MARGIN, a.c, a.len, ld });
+            identity = -1;
+            break;
+        case OP_GAP: {
+            vec = 0;
+            s.vec[vec].resize(a.c);
+            for (int r = 0; r < a.c; r++) {
+                const float *v = row(a, r);
+                float sum = 0.0f;
+                for (int t = 0; t < a.len; t++) {
+                    sum += v[t];
+                }
+                s.vec[vec][r] = a.len > 0 ? sum / a.len : 0.0f;
+            }
+            break;
+        }
+        case OP_LINEAR:
+            s.vec[vec ^ 1].resize(op.out);
+            linear(op, s.vec[vec].data(), s.vec[vec ^ 1].data());
+            vec ^= 1;
+            break;
+        }
+    }
+    memcpy(logits, s.vec[vec].data(), (size_t)model.num_classes * sizeof(float));
+}
+
+}  // namespace
+
+std::string model_load(const std::string &path, model_t &model)
+{
+    std::ifstream f(path, std::ios::binary);
+    if (!f) {
+        return "cannot open " + path;
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(f)),
+                           std::istreambuf_iterator<char>());
+    reader_t rd{ data.data(), data.data() + data.size() };
+
+    if (data.size() < 4 || memcmp(data.data(), "IMLW", 4) != 0) {
+        return "bad magic in " + path;
+    }
+    rd.p += 4;
+    if (rd.u32() != 1) {
+        return "unsupported weight file version";
+    }
+    model.feature = (feature_t)rd.u32();
+    model.seq_len = (int)rd.u32();
+    model.stride = (int)rd.u32();
+    model.num_classes = (int)rd.u32();
+    uint32_t num_ops = rd.u32();
+
+    for (int i = 0; i < model.num_classes && rd.ok; i++) {
+        uint32_t len = rd.u32();
+        if ((size_t)(rd.end - rd.p) < len) {
+            rd.ok = false;
+            break;
+        }
+        model.labels.emplace_back(rd.p, len);
+        rd.p += len;
+    }
+
+    int channels = 1;
+    int features = -1;
+    int res_channels = -1;
+    for (uint32_t i = 0; i < num_ops && rd.ok; i++) {
+        op_t op;
+        op.type = (op_type_t)rd.u32();
+        switch (op.type) {
+        case OP_CONV:
+            op.in = (int)rd.u32();
+            op.out = (int)rd.u32();
+            op.k = (int)rd.u32();
+            op.pad = (int)rd.u32();
+            op.relu = rd.u32() != 0;
+            if (op.in != channels || op.k != 2 * op.pad + 1 || op.pad > MARGIN - LANES) {
+                return "unsupported conv at op " + std::to_string(i);
+            }
+            rd.f32(op.w, (size_t)op.out * op.in * op.k);
+            rd.f32(op.b, (size_t)op.out);
+            channels = op.out;
+            break;
+        case OP_MAXPOOL:
+            op.k = (int)rd.u32();
+            if (op.k < 1) {
+                return "bad maxpool at op " + std::to_string(i);
+            }
+            break;
+        case OP_RES_BEGIN:
+            res_channels = channels;
+            break;
+        case OP_RES_END:
+            if (res_channels != channels) {
+                return "residual channel mismatch at op " + std::to_string(i);
+            }
+            break;
+        case OP_GAP:
+            features = channels;
+            break;
+        case OP_LINEAR:
+            op.in = (int)rd.u32();
+            op.out = (int)rd.u32();
+            op.relu = rd.u32() != 0;
+            if (op.in != features) {
+                return "linear input mismatch at op " + std::to_string(i);
+            }
+            rd.f32(op.w, (size_t)op.out * op.in);
+            rd.f32(op.b, (size_t)op.out);
+            features = op.out;
+            break;
+        default:
+            return "unknown op type " + std::to_string(op.type);
+        }
+        model.ops.push_back(std::move(op));
+    }
+    if (!rd.ok) {
+        return "truncated weight file " + path;
+    }
+    if (features != model.num_classes || model.seq_len <= 0 || model.stride <= 0) {
+        return "inconsistent model header in " + path;
+    }
+    return "";
+}
+
+void model_forward(const model_t &model, thread_pool_t &pool,
+                   const float *x, int n, float *logits)
+{
+    pool.parallel_for(n, [&](int i) {
+        forward_one(model, x + (size_t)i * model.seq_len,
+                    logits + (size_t)i * model.num_classes);
+    });
+}
+
+void softmax(const float *logits, int n, float *probs)
+{
+    float m = *std::max_element(logits, logits + n);
+    float sum = 0.0f;
+    for (int i = 0; i < n; i++) {
+        probs[i] = std::exp(logits[i] - m);
+        sum += probs[i];
+    }
+    for (int i = 0; i < n; i++) {
+        probs[i] /= sum;
+    }
+}
+
+thread_pool_t::thread_pool_t(int threads)
+{
+    for (int i = 1; i < threads; i++) {
+        m_workers.emplace_back(&thread_pool_t::worker, this, i);
+    }
+}
+
+thread_pool_t::~thread_pool_t()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_start.notify_all();
+    for (std::thread &t : m_workers) {
+        t.join();
+    }
+}
+
+void thread_pool_t::parallel_for(int n, const std::function<void(int)> &fn)
+{
+    if (m_workers.empty() || n <= 1) {
+        for (int i = 0; i < n; i++) {
+            fn(i);
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_fn = &fn;
+        m_n = n;
+        m_next = 0;
+        m_busy = (int)m_workers.size();
+        m_generation++;
+    }
+    m_start.notify_all();
+
+    for (int i = m_next++; i < n; i = m_next++) {
+        fn(i);
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_busy == 0; });
+    m_fn = nullptr;
+}
+
+void thread_pool_t::worker(int id)
+{
+    uint64_t seen = 0;
+    (void)id;
+
+    for (;;) {
+        const std::function<void(int)> *fn;
+        int n;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start.wait(lock, [&] { return m_quit || m_generation != seen; });
+            if (m_quit) {
+                return;
+            }
+            seen = m_generation;
+            fn = m_fn;
+            n = m_n;
+        }
+        for (int i = m_next++; i < n; i = m_next++) {
+            (*fn)(i);
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_busy--;
+        }
+        m_done.notify_one();
+    }
+}
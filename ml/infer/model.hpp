@@ -0,0 +1,89 @@
+/*
+ * Native forward pass for the exported CNN1D / ResNet1D weights
+ * (src/export_model.py). BatchNorm is already folded into the convolutions;
+ * a batch of windows is split across a small thread pool.
+ */
+
+#ifndef INFER_MODEL_HPP
+#define INFER_MODEL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum feature_t {
+    FEATURE_RSSI = 0,       /* rssi_diff, as in prepare_data.py */
+    FEATURE_LATENCY = 1,    /* inter-arrival seconds, as in prepare_latency_data.py */
+};
+
+enum op_type_t {
+    OP_CONV = 1,
+    OP_MAXPOOL = 2,
+    OP_RES_BEGIN = 3,
+    OP_RES_END = 4,
+    OP_GAP = 5,
+    OP_LINEAR = 6,
+};
+
+struct op_t {
+    op_type_t type;
+    int in = 0;             /* conv: in channels, linear: in features */
+    int out = 0;            /* conv: out channels, linear: out features */
+    int k = 0;              /* conv / maxpool kernel */
+    int pad = 0;
+    bool relu = false;
+    std::vector<float> w;
+    std::vector<float> b;
+};
+
+struct model_t {
+    feature_t feature = FEATURE_RSSI;
+    int seq_len = 0;
+    int stride = 0;
+    int num_classes = 0;
+    std::vector<std::string> labels;
+    std::vector<op_t> ops;
+};
+
+/* Returns an empty string on success, otherwise the reason. */
+std::string model_load(const std::string &path, model_t &model);
+
+class thread_pool_t {
+public:
+    explicit thread_pool_t(int threads);
+    ~thread_pool_t();
+
+    int size() const { return (int)m_workers.size() + 1; }
+    /* Run fn(i) for i in [0, n); the calling thread takes part. */
+    void parallel_for(int n, const std::function<void(int)> &fn);
+
+private:
+    void worker(int id);
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_start;
+    std::condition_variable m_done;
+    const std::function<void(int)> *m_fn = nullptr;
+    int m_n = 0;
+    std::atomic<int> m_next{0};
+    int m_busy = 0;
+    uint64_t m_generation = 0;
+    bool m_quit = false;
+};
+
+/*
+ * Forward a batch: x holds n windows of model.seq_len floats, logits receives
+ * n * model.num_classes floats.
+ */
+void model_forward(const model_t &model, thread_pool_t &pool,
+                   const float *x, int n, float *logits);
+
+void softmax(const float *logits, int n, float *probs);
+
+#endif /* INFER_MODEL_HPP */
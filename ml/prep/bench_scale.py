@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""Peak memory of dataset preparation on a synthetically extended capture.
+
+    python prep/bench_scale.py --scale 100 [--task node --seq_len 100 --overlap 0.5]
+
+Every data/raw capture is repeated --scale times, each copy shifted by whole
+days so timestamps stay in order, and written to --workdir (default prep/bin,
+on disk: /tmp is often RAM-backed and would count against RSS). Each measurement
+runs in a fresh process and reports its peak RSS:
+
+  pandas  x1        create_dataset() on data/raw
+  stream  x1        create_dataset_stream() + npz on data/raw
+  stream  x<scale>  create_dataset_stream() + npz on the extended capture
+
+Run from ml/.
+"""
+import argparse
+import datetime
+import json
+import os
+import resource
+import subprocess
+import sys
+import tempfile
+import time
+
+PREP_DIR = os.path.dirname(os.path.abspath(__file__))
+SRC_DIR = os.path.join(PREP_DIR, "..", "src")
+
+
+def extend(path, out_path, scale):
+    with open(path) as f:
+        header = f.readline()
+        lines = f.readlines()
+    first = datetime.date.fromisoformat(lines[0][:10])
+    last = datetime.date.fromisoformat(lines[-1][:10])
+    shift = (last - first).days + 1
+    dates = sorted({line[:10] for line in lines})
+
+    with open(out_path, "w") as f:
+        f.write(header)
+        for k in range(scale):
+            new = {d: (datetime.date.fromisoformat(d) + datetime.timedelta(days=k * shift)).isoformat()
+                   for d in dates}
+            f.writelines(new[line[:10]] + line[10:] for line in lines)
+    return len(lines) * scale
+
+
+def measure(engine, files, args):
+    sys.path.insert(0, SRC_DIR)
+    import numpy as np
+    import prepare_data
+    import stream_prep
+
+    t0 = time.perf_counter()
+    if engine == "pandas":
+        X, *_ = prepare_data.create_dataset(args.task, args.seq_len, args.overlap)
+    else:
+        out_path = os.path.join(args.workdir, "bench.npz")
+        x_path = out_path + ".X.tmp"
+        X, y, env_ids, node_ids = prepare_data.create_dataset_stream(
+            args.task, args.seq_len, args.overlap, x_path=x_path, files=files)
+        stream_prep.savez(out_path, x_path, X.shape, y=y, env_ids=env_ids, node_ids=node_ids)
+        os.remove(x_path)
+        os.remove(out_path)
+    seconds = time.perf_counter() - t0
+    rss_kb = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    print(json.dumps({"windows": int(np.shape(X)[0]), "seconds": round(seconds, 2),
+                      "max_rss_kb": rss_kb}))
+
+
+def run_child(engine, files, args):
+    cmd = [sys.executable, __file__, "--child", engine, "--task", args.task,
+           "--seq_len", str(args.seq_len), "--overlap", str(args.overlap),
+           "--workdir", args.workdir, *files]
+    out = subprocess.run(cmd, check=True, stdout=subprocess.PIPE, text=True).stdout
+    return json.loads(out.strip().splitlines()[-1])
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--scale", type=int, default=100)
+    parser.add_argument("--task", type=str, default="node", choices=["node", "env"])
+    parser.add_argument("--seq_len", type=int, default=100)
+    parser.add_argument("--overlap", type=float, default=0.5)
+    parser.add_argument("--workdir", type=str, default=os.path.join(PREP_DIR, "bin"),
+                        help="where the extended capture is written (default: prep/bin)")
+    parser.add_argument("--child", type=str, default=None, help=argparse.SUPPRESS)
+    parser.add_argument("files", nargs="*", help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.child:
+        measure(args.child, args.files, args)
+        return
+
+    sys.path.insert(0, SRC_DIR)
+    from prepare_data import FILES
+
+    os.makedirs(args.workdir, exist_ok=True)
+    with tempfile.TemporaryDirectory(dir=args.workdir) as workdir:
+        args.workdir = workdir
+        raw_rows = 0
+        scaled = []
+        for path in FILES:
+            out_path = os.path.join(workdir, os.path.basename(path))
+            raw_rows += extend(path, out_path, args.scale)
+            scaled.append(out_path)
+        size_mb = sum(os.path.getsize(p) for p in scaled) / 1e6
+
+        print(f"{'engine':8} {'capture':>8} {'rows':>12} {'windows':>10} {'seconds':>9} {'max RSS MB':>11}")
+        for engine, files, scale in (("pandas", FILES, 1), ("stream", FILES, 1),
+                                     ("stream", scaled, args.scale)):
+            r = run_child(engine, files, args)
+            rows = raw_rows // args.scale * scale
+            print(f"{engine:8} {'x' + str(scale):>8} {rows:12d} {r['windows']:10d} "
+                  f"{r['seconds']:9.2f} {r['max_rss_kb'] / 1024:11.1f}", flush=True)
+        print(f"# x{args.scale} capture: {size_mb:.0f} MB of CSV")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,39 @@
+#!/usr/bin/env python3
+"""Check that create_dataset_stream() matches create_dataset() exactly.
+
+Runs every configuration built by src/prepare_all_data.py on data/raw and
+compares X, y, env_ids and node_ids (values and dtypes). Run from ml/.
+"""
+import os
+import sys
+
+import numpy as np
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src"))
+
+from prepare_data import create_dataset, create_dataset_stream  # noqa: E402
+
+TASKS = ["node", "env"]
+SEQ_LENS = [100, 500, 1000]
+OVERLAPS = [0.4, 0.5]
+
+
+def main():
+    failed = 0
+    for task in TASKS:
+        for seq_len in SEQ_LENS:
+            for overlap in OVERLAPS:
+                ref = create_dataset(task, seq_len, overlap)
+                got = create_dataset_stream(task, seq_len, overlap)
+                same = all(a.dtype == b.dtype and a.shape == b.shape and np.array_equal(a, b)
+                           for a, b in zip(ref, got))
+                print(f"{task} seq_len={seq_len} overlap={overlap}: X {got[0].shape} "
+                      f"{'ok' if same else 'MISMATCH'}")
+                failed += not same
+    if failed:
+        print(f"{failed} configuration(s) differ")
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,396 @@
+/*
+ * Streaming dataset preparation: a bounded-memory version of create_dataset()
+ * in src/prepare_data.py, loaded through ctypes by src/stream_prep.py.
+ *
+ * Every capture is read twice in fixed-size chunks:
+ *   1. per device: row count, rssi_diff min/max, hence the number of windows
+ *   2. per device: rssi_diff -> min-max normalization -> windows, written
+ *      straight into their final rows of a memory-mapped float32 output file
+ *
+ * Pass 1 fixes the output range of every (file, device) pair up front, so the
+ * rows come out in create_dataset() order (file, device, time) even though the
+ * devices are interleaved in the capture. Memory use is one chunk plus a
+ * seq_len ring per device; finished output pages are dropped from the mapping
+ * as the writers move past them, so the output size does not count towards RSS.
+ *
+ * Rows must be in time order per device, as written by log_rx.sh; rows with
+ * equal timestamps keep their file order.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "rx_csv.h"
+
+namespace {
+
+struct device_t {
+    std::string name;
+
+    /* pass 1 */
+    int64_t rows = 0;
+    int64_t diffs = 0;
+    double lo = 0.0;
+    double hi = 0.0;
+    int64_t windows = 0;
+
+    /* pass 2 */
+    int64_t out_row = 0;        /* first output row of this (file, device) */
+    int64_t emitted = 0;
+    int64_t seen = 0;           /* normalized values pushed into ring */
+    std::vector<float> ring;
+    size_t released = 0;        /* output bytes already dropped from the mapping */
+
+    /* both passes */
+    int64_t last_ts = 0;
+    int prev_rssi = 0;
+    bool have_prev = false;
+
+    void reset()
+    {
+        have_prev = false;
+        last_ts = INT64_MIN;
+    }
+};
+
+/* Growable, file-backed float32 matrix with seq_len columns. */
+struct output_t {
+    int fd = -1;
+    float *map = nullptr;
+    size_t row_bytes = 0;
+    int64_t cap = 0;
+    int64_t rows = 0;
+
+    std::string open(const char *path, int seq_len)
+    {
+        fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            return std::string("cannot create ") + path;
+        }
+        row_bytes = (size_t)seq_len * sizeof(float);
+        return "";
+    }
+
+    std::string reserve(int64_t need)
+    {
+        if (need <= cap) {
+            return "";
+        }
+        int64_t new_cap = std::max(need, cap * 2);
+        if (map) {
+            munmap(map, (size_t)cap * row_bytes);
+            map = nullptr;
+        }
+        if (ftruncate(fd, (off_t)((size_t)new_cap * row_bytes)) != 0) {
+            return "cannot grow output to " + std::to_string(new_cap) + " windows";
+        }
+        void *p = mmap(nullptr, (size_t)new_cap * row_bytes, PROT_READ | PROT_WRITE,
+                       MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            return "cannot map output";
+        }
+        map = (float *)p;
+        cap = new_cap;
+        return "";
+    }
+
+    /* Drop [from, to) from the mapping; the data stays in the file. */
+    void release(size_t from, size_t to)
+    {
+        const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        from -= from % page;
+        to -= to % page;
+        if (map && to > from) {
+            madvise((char *)map + from, to - from, MADV_DONTNEED);
+        }
+    }
+
+    std::string close()
+    {
+        std::string err;
+        if (map) {
+            munmap(map, (size_t)cap * row_bytes);
+            map = nullptr;
+        }
+        if (fd >= 0) {
+            if (ftruncate(fd, (off_t)((size_t)rows * row_bytes)) != 0) {
+                err = "cannot truncate output";
+            }
+            ::close(fd);
+            fd = -1;
+        }
+        return err;
+    }
+};
+
+/*
+ * Call row_fn(row, line_no) for every data row of path, reading chunk_bytes
+ * at a time, and chunk_fn() after each chunk. Stops at the first error.
+ */
+template <typename RowFn, typename ChunkFn>
+std::string for_each_row(const char *path, size_t chunk_bytes, RowFn row_fn, ChunkFn chunk_fn)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return std::string("cannot open ") + path;
+    }
+
+    std::vector<char> buf(chunk_bytes);
+    std::string err;
+    size_t have = 0;
+    size_t line_no = 0;
+    rx_row_t row;
+    bool eof = false;
+
+    while (!eof && err.empty()) {
+        size_t n = fread(buf.data() + have, 1, buf.size() - have, f);
+        have += n;
+        eof = n == 0;
+        if (eof && have > 0 && buf[have - 1] != '\n') {
+            buf.resize(std::max(buf.size(), have + 1));
+            buf[have++] = '\n';     /* last line without newline */
+        }
+
+        size_t start = 0;
+        for (;;) {
+            char *nl = (char *)memchr(buf.data() + start, '\n', have - start);
+            if (!nl) {
+                break;
+            }
+            size_t len = (size_t)(nl - (buf.data() + start));
+            const char *line = buf.data() + start;
+            start += len + 1;
+            line_no++;
+
+            if (len == 0 || (len == 1 && line[0] == '\r')) {
+                continue;
+            }
+            if (line_no == 1 && strncmp(line, "ts,", 3) == 0) {
+                continue;
+            }
+            if (rx_csv_parse_line(line, len, &row) != 0) {
+                err = std::string(path) + ":" + std::to_string(line_no) + ": malformed row";
+                break;
+            }
+            err = row_fn(row, line_no);
+            if (!err.empty()) {
+                break;
+            }
+        }
+        if (!err.empty()) {
+            break;
+        }
+        if (start == 0 && have == buf.size()) {
+            err = std::string(path) + ":" + std::to_string(line_no + 1) +
+                  ": line longer than the chunk size";
+            break;
+        }
+        memmove(buf.data(), buf.data() + start, have - start);
+        have -= start;
+        chunk_fn();
+    }
+    if (err.empty() && ferror(f)) {
+        err = std::string("read error in ") + path;
+    }
+    fclose(f);
+    return err;
+}
+
+device_t *find_device(std::vector<device_t> &devs, const char *name)
+{
+    for (auto &d : devs) {
+        if (d.name == name) {
+            return &d;
+        }
+    }
+    return nullptr;
+}
+
+std::string check_order(const device_t &d, const rx_row_t &row, const char *path,
+                        size_t line_no)
+{
+    if (row.ts_ms < d.last_ts) {
+        return std::string(path) + ":" + std::to_string(line_no) + ": " + d.name +
+               " rows are not in time order";
+    }
+    return "";
+}
+
+std::string scan_file(const char *path, std::vector<device_t> &devs, int seq_len,
+                      int stride, size_t chunk_bytes)
+{
+    for (auto &d : devs) {
+        d.reset();
+        d.rows = 0;
+        d.diffs = 0;
+        d.windows = 0;
+    }
+
+    auto row_fn = [&](const rx_row_t &row, size_t line_no) -> std::string {
+        device_t *d = find_device(devs, row.device);
+        if (!d) {
+            return "";
+        }
+        std::string err = check_order(*d, row, path, line_no);
+        if (!err.empty()) {
+            return err;
+        }
+        d->last_ts = row.ts_ms;
+        d->rows++;
+        if (d->have_prev) {
+            double diff = (double)(row.rssi - d->prev_rssi);
+            if (d->diffs == 0 || diff < d->lo) {
+                d->lo = diff;
+            }
+            if (d->diffs == 0 || diff > d->hi) {
+                d->hi = diff;
+            }
+            d->diffs++;
+        }
+        d->prev_rssi = row.rssi;
+        d->have_prev = true;
+        return "";
+    };
+    std::string err = for_each_row(path, chunk_bytes, row_fn, [] {});
+    if (!err.empty()) {
+        return err;
+    }
+
+    /* Same skips as create_dataset(): short streams and constant rssi_diff */
+    for (auto &d : devs) {
+        if (d.rows < seq_len || d.diffs < seq_len || d.hi - d.lo == 0.0) {
+            continue;
+        }
+        d.windows = (d.diffs - seq_len) / stride + 1;
+    }
+    return "";
+}
+
+std::string write_file(const char *path, std::vector<device_t> &devs, output_t &out,
+                       int seq_len, int stride, size_t chunk_bytes)
+{
+    for (auto &d : devs) {
+        d.reset();
+        d.emitted = 0;
+        d.seen = 0;
+        d.out_row = out.rows;
+        d.released = (size_t)d.out_row * out.row_bytes;
+        out.rows += d.windows;
+        if (d.windows > 0) {
+            d.ring.assign((size_t)seq_len, 0.0f);
+        }
+    }
+    std::string err = out.reserve(out.rows);
+    if (!err.empty()) {
+        return err;
+    }
+
+    auto row_fn = [&](const rx_row_t &row, size_t line_no) -> std::string {
+        device_t *d = find_device(devs, row.device);
+        if (!d || d->windows == 0) {
+            return "";
+        }
+        std::string err = check_order(*d, row, path, line_no);
+        if (!err.empty()) {
+            return err;
+        }
+        d->last_ts = row.ts_ms;
+        if (d->have_prev && d->emitted < d->windows) {
+            double diff = (double)(row.rssi - d->prev_rssi);
+            float v = (float)((diff - d->lo) / (d->hi - d->lo));
+            size_t pos = (size_t)(d->seen % seq_len);
+            d->ring[pos] = v;
+            d->seen++;
+
+            int64_t first = d->seen - seq_len;
+            if (first >= 0 && first % stride == 0) {
+                /* ring[pos + 1..] holds the oldest values */
+                float *dst = out.map + (size_t)(d->out_row + d->emitted) * (size_t)seq_len;
+                size_t head = (size_t)seq_len - pos - 1;
+                memcpy(dst, d->ring.data() + pos + 1, head * sizeof(float));
+                memcpy(dst + head, d->ring.data(), (pos + 1) * sizeof(float));
+                d->emitted++;
+            }
+        }
+        d->prev_rssi = row.rssi;
+        d->have_prev = true;
+        return "";
+    };
+    auto chunk_fn = [&] {
+        for (auto &d : devs) {
+            size_t written = (size_t)(d.out_row + d.emitted) * out.row_bytes;
+            out.release(d.released, written);
+            d.released = std::max(d.released, written - written % (size_t)sysconf(_SC_PAGESIZE));
+        }
+    };
+    err = for_each_row(path, chunk_bytes, row_fn, chunk_fn);
+    if (!err.empty()) {
+        return err;
+    }
+    for (auto &d : devs) {
+        if (d.emitted != d.windows) {
+            return std::string(path) + ": " + d.name + " changed between passes";
+        }
+        d.ring.clear();
+        d.ring.shrink_to_fit();
+    }
+    return "";
+}
+
+thread_local std::string g_error;
+
+}  // namespace
+
+extern "C" {
+
+/*
+ * Build the rssi_diff windows of files into out_path (raw float32, one row of
+ * seq_len values per window). windows receives n_files * n_devices counts in
+ * output order: file-major, devices in the given order. Returns NULL on
+ * success, otherwise the reason (valid until the next call on this thread).
+ */
+const char *stream_prep_run(const char *const *files, int n_files,
+                            const char *const *devices, int n_devices,
+                            int seq_len, int stride, size_t chunk_bytes,
+                            const char *out_path, int64_t *windows)
+{
+    if (seq_len <= 0 || stride <= 0) {
+        g_error = "seq_len and stride must be positive";
+        return g_error.c_str();
+    }
+    if (chunk_bytes < 4096) {
+        chunk_bytes = 4096;
+    }
+
+    std::vector<device_t> devs((size_t)n_devices);
+    for (int i = 0; i < n_devices; i++) {
+        devs[(size_t)i].name = devices[i];
+    }
+
+    output_t out;
+    g_error = out.open(out_path, seq_len);
+    for (int f = 0; f < n_files && g_error.empty(); f++) {
+        g_error = scan_file(files[f], devs, seq_len, stride, chunk_bytes);
+        if (g_error.empty()) {
+            g_error = write_file(files[f], devs, out, seq_len, stride, chunk_bytes);
+        }
+        for (int i = 0; i < n_devices; i++) {
+            windows[(size_t)f * (size_t)n_devices + (size_t)i] = devs[(size_t)i].windows;
+        }
+    }
+    std::string close_err = out.close();
+    if (g_error.empty()) {
+        g_error = close_err;
+    }
+    return g_error.empty() ? nullptr : g_error.c_str();
+}
+
+}  // extern "C"
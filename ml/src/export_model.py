@@ -0,0 +1,98 @@
+# src/export_model.py
+# Export a trained best_model.pt into the flat weight file read by the native
+# inference daemon (infer/), folding BatchNorm into the preceding Conv1d, and
+# optionally a parity file of processed windows with the PyTorch logits.
+import os
+import argparse
+import numpy as np
+import torch
+import torch.nn as nn
+
+from models.cnn import CNN1D
+from models.resnet import ResNet1D, ResidualBlock1D
+from utils.model_file import (OP_MAXPOOL, OP_RES_BEGIN, OP_RES_END, OP_GAP,
+                              pack_u32, pack_conv, pack_linear,
+                              load_experiment, write_model, write_parity)
+
+
+def parse_args():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--exp", type=str, required=True,
+                        help="experiment folder, e.g. outputs/node_seq100_ov50_random_cnn")
+    parser.add_argument("--out", type=str, default=None,
+                        help="weight file (default: <exp>/model.bin)")
+    parser.add_argument("--parity", type=int, default=0,
+                        help="also write <exp>/parity.bin with this many processed windows")
+    return parser.parse_args()
+
+
+def fold_bn(conv, bn):
+    scale = bn.weight / torch.sqrt(bn.running_var + bn.eps)
+    weight = conv.weight * scale[:, None, None]
+    bias = (conv.bias - bn.running_mean) * scale + bn.bias
+    return weight.detach().numpy(), bias.detach().numpy()
+
+
+def pack_conv_bn(conv, bn, relu):
+    weight, bias = fold_bn(conv, bn)
+    return pack_conv(weight, bias, conv.padding[0], relu)
+
+
+def export_ops(model):
+    ops = []
+    layers = list(model.features)
+    i = 0
+    while i < len(layers):
+        layer = layers[i]
+        if isinstance(layer, nn.Conv1d):
+            relu = i + 2 < len(layers) and isinstance(layers[i + 2], nn.ReLU)
+            ops.append(pack_conv_bn(layer, layers[i + 1], relu))
+            i += 3 if relu else 2
+            continue
+        if isinstance(layer, nn.MaxPool1d):
+            ops.append(pack_u32(OP_MAXPOOL, layer.kernel_size))
+        elif isinstance(layer, ResidualBlock1D):
+            ops.append(pack_u32(OP_RES_BEGIN))
+            ops.append(pack_conv_bn(layer.conv1, layer.bn1, True))
+            ops.append(pack_conv_bn(layer.conv2, layer.bn2, False))
+            ops.append(pack_u32(OP_RES_END))
+        elif isinstance(layer, nn.AdaptiveAvgPool1d):
+            ops.append(pack_u32(OP_GAP))
+        else:
+            raise ValueError(f"Unsupported feature layer: {layer}")
+        i += 1
+
+    layers = list(model.classifier)
+    for i, layer in enumerate(layers):
+        if isinstance(layer, nn.Linear):
+            relu = i + 1 < len(layers) and isinstance(layers[i + 1], nn.ReLU)
+            ops.append(pack_linear(layer.weight.detach().numpy(),
+                                   layer.bias.detach().numpy(), relu))
+        elif not isinstance(layer, (nn.Flatten, nn.ReLU, nn.Dropout)):
+            raise ValueError(f"Unsupported classifier layer: {layer}")
+    return ops
+
+
+def main():
+    args = parse_args()
+
+    info = load_experiment(args.exp)
+    state = torch.load(os.path.join(args.exp, "best_model.pt"), map_location="cpu")
+    num_classes = state["classifier.4.weight"].shape[0]
+
+    model = CNN1D(num_classes) if info["metrics"]["model"] == "cnn" else ResNet1D(num_classes)
+    model.load_state_dict(state)
+    model.eval()
+
+    write_model(args.out or os.path.join(args.exp, "model.bin"), info, num_classes,
+                export_ops(model))
+
+    if args.parity > 0:
+        X = np.load(info["data_path"])["X"][:args.parity].astype(np.float32)
+        with torch.no_grad():
+            logits = model(torch.from_numpy(X[:, np.newaxis, :])).numpy()
+        write_parity(os.path.join(args.exp, "parity.bin"), X, logits)
+
+
+if __name__ == "__main__":
+    main()
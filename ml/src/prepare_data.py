@@ -1,9 +1,12 @@
 # src/prepare_data.py
 import os
 import argparse
+import tempfile
 import numpy as np
 import pandas as pd
 
+import stream_prep
+
 FILES = [
     "data/raw/e0-bridge.csv",
     "data/raw/e1-lake.csv",
@@ -12,6 +15,8 @@ FILES = [
     "data/raw/e4-garden.csv"
 ]
 
+PROCESSED_DIR = "data/processed"
+
 DEVICE_TO_LABEL = {
     "RIOT-BLE-0": 0,
     "RIOT-BLE-1": 1,
@@ -67,23 +72,76 @@ def create_dataset(task="node", seq_len=100, overlap=0.5):
     return X, y, env_ids,node_ids
 
 
+def create_dataset_stream(task="node", seq_len=100, overlap=0.5, x_path=None,
+                          files=FILES, chunk_bytes=1 << 20):
+    """Same output as create_dataset(), built by the native streaming engine.
+
+    Memory stays bounded by the chunk size: X is a read-only memmap of the raw
+    float32 file x_path. If None, a temporary file next to the processed
+    datasets is used and removed once mapped; X can be as large as the npz, so
+    it is kept out of /tmp, which is often RAM-backed.
+    """
+    if task not in ("node", "env"):
+        raise ValueError("task must be 'node' or 'env'")
+    stride = int(seq_len * (1 - overlap))
+    devices = list(DEVICE_TO_LABEL)
+
+    tmp = x_path is None
+    if tmp:
+        os.makedirs(PROCESSED_DIR, exist_ok=True)
+        fd, x_path = tempfile.mkstemp(suffix=".X.tmp", dir=PROCESSED_DIR)
+        os.close(fd)
+    try:
+        windows = stream_prep.run(files, devices, seq_len, stride, x_path, chunk_bytes)
+        n = int(windows.sum())
+        if n > 0:
+            X = np.memmap(x_path, dtype=np.float32, mode="r", shape=(n, seq_len))
+        else:
+            X = np.zeros((0,), dtype=np.float32)
+    finally:
+        if tmp:
+            os.remove(x_path)
+
+    counts = windows.ravel()
+    env_ids = np.repeat(np.repeat(np.arange(len(files), dtype=np.int64), len(devices)), counts)
+    node_ids = np.repeat(np.tile(np.array([DEVICE_TO_LABEL[d] for d in devices], dtype=np.int64),
+                                 len(files)), counts)
+    y = node_ids.copy() if task == "node" else env_ids.copy()
+    return X, y, env_ids, node_ids
+
+
 def main():
     parser = argparse.ArgumentParser()
     parser.add_argument("--task", type=str, required=True, choices=["node", "env"])
     parser.add_argument("--seq_len", type=int, required=True)
     parser.add_argument("--overlap", type=float, required=True)
+    parser.add_argument("--engine", type=str, default="pandas", choices=["pandas", "stream"],
+                        help="stream: native chunked engine with bounded memory (make -C ml/prep)")
     args = parser.parse_args()
 
-    X, y, env_ids ,node_ids= create_dataset(
-        task=args.task,
-        seq_len=args.seq_len,
-        overlap=args.overlap
-    )
-
-    os.makedirs("data/processed", exist_ok=True)
-    out_path = f"data/processed/{args.task}_seq{args.seq_len}_ov{int(args.overlap*100)}.npz"
-
-    np.savez(out_path, X=X, y=y, env_ids=env_ids,node_ids=node_ids)
+    os.makedirs(PROCESSED_DIR, exist_ok=True)
+    out_path = f"{PROCESSED_DIR}/{args.task}_seq{args.seq_len}_ov{int(args.overlap*100)}.npz"
+
+    if args.engine == "stream":
+        x_path = out_path + ".X.tmp"
+        try:
+            X, y, env_ids, node_ids = create_dataset_stream(
+                task=args.task,
+                seq_len=args.seq_len,
+                overlap=args.overlap,
+                x_path=x_path
+            )
+            stream_prep.savez(out_path, x_path, X.shape, y=y, env_ids=env_ids, node_ids=node_ids)
+        finally:
+            if os.path.exists(x_path):
+                os.remove(x_path)
+    else:
+        X, y, env_ids ,node_ids= create_dataset(
+            task=args.task,
+            seq_len=args.seq_len,
+            overlap=args.overlap
+        )
+        np.savez(out_path, X=X, y=y, env_ids=env_ids,node_ids=node_ids)
 
     print("Saved to:", out_path)
     print("X shape:", X.shape)
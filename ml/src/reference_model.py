@@ -0,0 +1,219 @@
+# src/reference_model.py
+# Parity check for the native inference daemon (infer/) without torch. Reads
+# best_model.pt straight from its zip archive, writes <exp>/model.bin with
+# BatchNorm folded like export_model.py, and <exp>/parity.bin with the logits
+# of a float64 NumPy forward pass of the unfolded eval-mode model, layer by
+# layer as in models/cnn.py and models/resnet.py. For one-out splits,
+# --confusion also classifies the whole test split and compares the result
+# with the confusion_matrix.npy that PyTorch wrote after training.
+import sys
+import os
+import pickle
+import zipfile
+import argparse
+import collections
+import numpy as np
+
+from utils.model_file import (OP_MAXPOOL, OP_RES_BEGIN, OP_RES_END, OP_GAP,
+                              pack_u32, pack_conv, pack_linear,
+                              load_experiment, write_model, write_parity)
+
+BN_EPS = 1e-5       # nn.BatchNorm1d default
+BATCH = 64
+
+# state_dict prefixes of CNN1D / ResNet1D, in forward order
+LAYERS = {
+    "cnn": [
+        ("conv", "features.0", "features.1", True), ("maxpool", 2),
+        ("conv", "features.4", "features.5", True), ("maxpool", 2),
+        ("conv", "features.8", "features.9", True),
+        ("gap",),
+        ("linear", "classifier.1", True), ("linear", "classifier.4", False),
+    ],
+    "resnet": [
+        ("conv", "features.0", "features.1", True), ("maxpool", 2),
+        ("res", "features.4"),
+        ("conv", "features.5", "features.6", True), ("maxpool", 2),
+        ("res", "features.9"),
+        ("conv", "features.10", "features.11", True),
+        ("res", "features.13"),
+        ("gap",),
+        ("linear", "classifier.1", True), ("linear", "classifier.4", False),
+    ],
+}
+
+STORAGE_DTYPES = {
+    "FloatStorage": "<f4",
+    "DoubleStorage": "<f8",
+    "LongStorage": "<i8",
+    "IntStorage": "<i4",
+}
+
+
+def rebuild_tensor(storage, offset, size, stride, *args):
+    item = storage.itemsize
+    return np.lib.stride_tricks.as_strided(
+        storage[offset:], shape=size, strides=[s * item for s in stride]).copy()
+
+
+class CheckpointUnpickler(pickle.Unpickler):
+    """Unpickles a torch.save() state_dict into NumPy arrays, and nothing else."""
+
+    def __init__(self, archive, root):
+        super().__init__(archive.open(f"{root}/data.pkl"))
+        self.archive = archive
+        self.root = root
+
+    def find_class(self, module, name):
+        if module == "collections" and name == "OrderedDict":
+            return collections.OrderedDict
+        if module == "torch._utils" and name == "_rebuild_tensor_v2":
+            return rebuild_tensor
+        if module == "torch" and name in STORAGE_DTYPES:
+            return STORAGE_DTYPES[name]
+        raise pickle.UnpicklingError(f"unexpected {module}.{name} in checkpoint")
+
+    def persistent_load(self, pid):
+        _, dtype, key, _, numel = pid
+        data = self.archive.read(f"{self.root}/data/{key}")
+        return np.frombuffer(data, dtype=dtype)[:numel]
+
+
+def load_state(path):
+    with zipfile.ZipFile(path) as archive:
+        root = archive.namelist()[0].split("/")[0]
+        if archive.read(f"{root}/byteorder") != b"little":
+            raise ValueError(f"{path}: only little-endian checkpoints are supported")
+        state = CheckpointUnpickler(archive, root).load()
+    return {k: v.astype(np.float64) for k, v in state.items()
+            if not k.endswith("num_batches_tracked")}
+
+
+def conv1d(x, weight, bias):
+    k = weight.shape[2]
+    pad = k // 2
+    x = np.pad(x, ((0, 0), (0, 0), (pad, pad)))
+    windows = np.lib.stride_tricks.sliding_window_view(x, k, axis=2)
+    return np.einsum("nclk,ock->nol", windows, weight) + bias[None, :, None]
+
+
+def batch_norm(x, state, prefix):
+    scale = state[f"{prefix}.weight"] / np.sqrt(state[f"{prefix}.running_var"] + BN_EPS)
+    shift = state[f"{prefix}.bias"] - state[f"{prefix}.running_mean"] * scale
+    return x * scale[None, :, None] + shift[None, :, None]
+
+
+def conv_bn(x, state, conv, bn, relu):
+    x = batch_norm(conv1d(x, state[f"{conv}.weight"], state[f"{conv}.bias"]), state, bn)
+    return np.maximum(x, 0.0) if relu else x
+
+
+def forward(state, layers, X):
+    x = X[:, np.newaxis, :].astype(np.float64)
+    for layer in layers:
+        kind = layer[0]
+        if kind == "conv":
+            x = conv_bn(x, state, layer[1], layer[2], layer[3])
+        elif kind == "maxpool":
+            k = layer[1]
+            n, c, length = x.shape
+            x = x[:, :, :length // k * k].reshape(n, c, length // k, k).max(axis=3)
+        elif kind == "res":
+            p = layer[1]
+            out = conv_bn(x, state, f"{p}.conv1", f"{p}.bn1", True)
+            out = conv_bn(out, state, f"{p}.conv2", f"{p}.bn2", False)
+            x = np.maximum(out + x, 0.0)
+        elif kind == "gap":
+            x = x.mean(axis=2)
+        elif kind == "linear":
+            x = x @ state[f"{layer[1]}.weight"].T + state[f"{layer[1]}.bias"]
+            if layer[2]:
+                x = np.maximum(x, 0.0)
+    return x
+
+
+def pack_conv_bn(state, conv, bn, relu):
+    scale = state[f"{bn}.weight"] / np.sqrt(state[f"{bn}.running_var"] + BN_EPS)
+    weight = state[f"{conv}.weight"] * scale[:, None, None]
+    bias = (state[f"{conv}.bias"] - state[f"{bn}.running_mean"]) * scale + state[f"{bn}.bias"]
+    return pack_conv(weight, bias, weight.shape[2] // 2, relu)
+
+
+def export_ops(state, layers):
+    ops = []
+    for layer in layers:
+        kind = layer[0]
+        if kind == "conv":
+            ops.append(pack_conv_bn(state, layer[1], layer[2], layer[3]))
+        elif kind == "maxpool":
+            ops.append(pack_u32(OP_MAXPOOL, layer[1]))
+        elif kind == "res":
+            p = layer[1]
+            ops.append(pack_u32(OP_RES_BEGIN))
+            ops.append(pack_conv_bn(state, f"{p}.conv1", f"{p}.bn1", True))
+            ops.append(pack_conv_bn(state, f"{p}.conv2", f"{p}.bn2", False))
+            ops.append(pack_u32(OP_RES_END))
+        elif kind == "gap":
+            ops.append(pack_u32(OP_GAP))
+        elif kind == "linear":
+            ops.append(pack_linear(state[f"{layer[1]}.weight"], state[f"{layer[1]}.bias"], layer[2]))
+    return ops
+
+
+def predict(state, layers, X):
+    return np.concatenate([forward(state, layers, X[i:i + BATCH])
+                           for i in range(0, len(X), BATCH)])
+
+
+def check_confusion(exp, info, state, layers):
+    metrics = info["metrics"]
+    if metrics["split"] != "oneout":
+        print("confusion: skipped, the random split needs sklearn")
+        return True
+    data = np.load(info["data_path"])
+    if metrics["task"] == "node":
+        mask = data["env_ids"] == metrics["test_env"]
+    else:
+        mask = data["node_ids"] == metrics["test_node"]
+    y_true = data["y"][mask]
+    y_pred = predict(state, layers, data["X"][mask].astype(np.float32)).argmax(axis=1)
+
+    labels = np.union1d(y_true, y_pred)     # as sklearn's confusion_matrix
+    cm = np.zeros((len(labels), len(labels)), dtype=np.int64)
+    np.add.at(cm, (np.searchsorted(labels, y_true), np.searchsorted(labels, y_pred)), 1)
+    expected = np.load(os.path.join(exp, "confusion_matrix.npy"))
+    ok = cm.shape == expected.shape and bool((cm == expected).all())
+    print(f"confusion: windows={len(y_true)} {'matches' if ok else 'DIFFERS from'} training")
+    return ok
+
+
+def parse_args():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--exp", type=str, required=True,
+                        help="experiment folder, e.g. outputs/node_seq100_ov50_random_cnn")
+    parser.add_argument("--parity", type=int, default=512,
+                        help="number of processed windows in <exp>/parity.bin")
+    parser.add_argument("--confusion", action="store_true",
+                        help="check the test split against <exp>/confusion_matrix.npy")
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+
+    info = load_experiment(args.exp)
+    state = load_state(os.path.join(args.exp, "best_model.pt"))
+    layers = LAYERS[info["metrics"]["model"]]
+    num_classes = state["classifier.4.weight"].shape[0]
+
+    write_model(os.path.join(args.exp, "model.bin"), info, num_classes, export_ops(state, layers))
+
+    X = np.load(info["data_path"])["X"][:args.parity].astype(np.float32)
+    write_parity(os.path.join(args.exp, "parity.bin"), X, predict(state, layers, X))
+
+    if args.confusion and not check_confusion(args.exp, info, state, layers):
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,65 @@
+# src/stream_prep.py
+"""ctypes binding for the streaming data preparation engine (ml/prep).
+
+Build it once with `make -C ml/prep`.
+"""
+import ctypes
+import os
+import shutil
+import zipfile
+
+import numpy as np
+
+LIB_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                        "..", "prep", "bin", "libstream_prep.so")
+
+_lib = None
+
+
+def _load():
+    global _lib
+    if _lib is None:
+        if not os.path.exists(LIB_PATH):
+            raise RuntimeError(f"{LIB_PATH} not found, build it with `make -C ml/prep`")
+        _lib = ctypes.CDLL(LIB_PATH)
+        _lib.stream_prep_run.restype = ctypes.c_char_p
+        _lib.stream_prep_run.argtypes = [
+            ctypes.POINTER(ctypes.c_char_p), ctypes.c_int,
+            ctypes.POINTER(ctypes.c_char_p), ctypes.c_int,
+            ctypes.c_int, ctypes.c_int, ctypes.c_size_t,
+            ctypes.c_char_p, ctypes.POINTER(ctypes.c_int64),
+        ]
+    return _lib
+
+
+def run(files, devices, seq_len, stride, x_path, chunk_bytes=1 << 20):
+    """Write the windows of all files to x_path (raw float32, seq_len columns).
+
+    Returns an int64 array of shape (len(files), len(devices)) with the number
+    of windows per file and device, in output order.
+    """
+    lib = _load()
+    c_files = (ctypes.c_char_p * len(files))(*[os.fsencode(f) for f in files])
+    c_devices = (ctypes.c_char_p * len(devices))(*[d.encode() for d in devices])
+    windows = np.zeros((len(files), len(devices)), dtype=np.int64)
+
+    err = lib.stream_prep_run(c_files, len(files), c_devices, len(devices),
+                              seq_len, stride, chunk_bytes, os.fsencode(x_path),
+                              windows.ctypes.data_as(ctypes.POINTER(ctypes.c_int64)))
+    if err is not None:
+        raise RuntimeError(err.decode())
+    return windows
+
+
+def savez(out_path, x_path, x_shape, **arrays):
+    """np.savez() equivalent that copies X from the raw x_path file in chunks."""
+    with zipfile.ZipFile(out_path, "w", zipfile.ZIP_STORED, allowZip64=True) as zf:
+        with zf.open("X.npy", "w", force_zip64=True) as f:
+            np.lib.format.write_array_header_1_0(
+                f, {"descr": np.lib.format.dtype_to_descr(np.dtype(np.float32)),
+                    "fortran_order": False, "shape": tuple(x_shape)})
+            with open(x_path, "rb") as src:
+                shutil.copyfileobj(src, f, 1 << 20)
+        for name, arr in arrays.items():
+            with zf.open(name + ".npy", "w", force_zip64=True) as f:
+                np.lib.format.write_array(f, np.asanyarray(arr))
@@ -0,0 +1,78 @@
+# src/utils/model_file.py
+# Flat weight file read by the native inference daemon (infer/) and the parity
+# file it checks against. Kept free of torch so that reference_model.py can
+# write both without it.
+import os
+import json
+import struct
+import numpy as np
+
+MAGIC = b"IMLW"
+VERSION = 1
+
+OP_CONV = 1
+OP_MAXPOOL = 2
+OP_RES_BEGIN = 3
+OP_RES_END = 4
+OP_GAP = 5
+OP_LINEAR = 6
+
+FEATURE_RSSI = 0
+FEATURE_LATENCY = 1
+
+ENV_LABELS = ["bridge", "lake", "forest", "river", "garden"]
+NODE_LABELS = ["RIOT-BLE-0", "RIOT-BLE-1", "RIOT-BLE-2", "RIOT-BLE-3"]
+
+
+def pack_u32(*values):
+    return struct.pack(f"<{len(values)}I", *values)
+
+
+def pack_f32(array):
+    return np.ascontiguousarray(array, dtype="<f4").tobytes()
+
+
+def pack_conv(weight, bias, padding, relu):
+    cout, cin, k = weight.shape
+    return pack_u32(OP_CONV, cin, cout, k, padding, int(relu)) + pack_f32(weight) + pack_f32(bias)
+
+
+def pack_linear(weight, bias, relu):
+    cout, cin = weight.shape
+    return pack_u32(OP_LINEAR, cin, cout, int(relu)) + pack_f32(weight) + pack_f32(bias)
+
+
+def load_experiment(exp):
+    """metrics.json of an experiment plus what the model file needs from it."""
+    with open(os.path.join(exp, "metrics.json")) as f:
+        metrics = json.load(f)
+    latency = os.path.basename(os.path.normpath(exp)).startswith("latency_")
+    seq_len = metrics["seq_len"]
+    prefix = "latency_" if latency else ""
+    return {
+        "metrics": metrics,
+        "feature": FEATURE_LATENCY if latency else FEATURE_RSSI,
+        "seq_len": seq_len,
+        "stride": int(seq_len * (1 - metrics["overlap"])),
+        "labels": NODE_LABELS if metrics["task"] == "node" else ENV_LABELS,
+        "data_path": (f"data/processed/{prefix}{metrics['task']}_seq{seq_len}"
+                      f"_ov{int(metrics['overlap'] * 100)}.npz"),
+    }
+
+
+def write_model(path, info, num_classes, ops):
+    header = MAGIC + pack_u32(VERSION, info["feature"], info["seq_len"], info["stride"],
+                              num_classes, len(ops))
+    for label in info["labels"][:num_classes]:
+        header += pack_u32(len(label)) + label.encode()
+    with open(path, "wb") as f:
+        f.write(header)
+        for op in ops:
+            f.write(op)
+    print("Saved to:", path)
+
+
+def write_parity(path, X, logits):
+    with open(path, "wb") as f:
+        f.write(pack_u32(len(X), X.shape[1], logits.shape[1]) + pack_f32(X) + pack_f32(logits))
+    print("Saved to:", path, "windows:", len(X))